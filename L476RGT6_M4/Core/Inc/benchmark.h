@@ -0,0 +1,99 @@
+/**
+  ******************************************************************************
+  * @file    benchmark.h
+  * @brief   Cycle counter access and benchmark modes of the cipher harness.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __BENCHMARK_H
+#define __BENCHMARK_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "config.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* DWT (Data Watchpoint and Trace) registers, only exists on ARM Cortex with a DWT unit */
+
+#define KIN1_DWT_CONTROL             (*((volatile uint32_t*)0xE0001000))
+/*!< DWT Control register */
+#define KIN1_DWT_CYCCNTENA_BIT       (1UL<<0)
+/*!< CYCCNTENA bit in DWT_CONTROL register */
+#define KIN1_DWT_CYCCNT              (*((volatile uint32_t*)0xE0001004))
+/*!< DWT Cycle Counter register */
+#define KIN1_DEMCR                   (*((volatile uint32_t*)0xE000EDFC))
+/*!< DEMCR: Debug Exception and Monitor Control Register */
+#define KIN1_TRCENA_BIT              (1UL<<24)
+/*!< Trace enable bit in DEMCR register */
+
+/* Number of timed repetitions averaged for every result */
+#define BENCH_RUNS                   20
+
+/* Size of the ECB benchmark buffer in 32-bit words (3 KB, a multiple of
+   four 16 bytes blocks) */
+#define BENCH_WORDS                  768
+
+/* DMA UART pipeline (BENCH_UART_DMA): bytes encrypted and echoed per half of
+   the circular reception buffer (a multiple of every block), bytes expected
+   from the host at every baud rate, and time given to the host to start (ms) */
+#define UART_DMA_CHUNK               64
+#define UART_DMA_BYTES               8192
+#define UART_DMA_TIMEOUT             10000
+
+/* Crypto job queue under load (BENCH_JOBS): blocks of every job and time
+   the load is applied at each rate (ms) */
+#define BENCH_JOB_BLOCKS             4
+#define BENCH_JOB_WINDOW_MS          250
+
+/* Chunked encryption (BENCH_LATENCY): bytes of the buffer encrypted in
+   place, and period of the benchmark timer interrupt sampling the latency
+   (cycles, a prime so the samples fall at every phase of the steps) */
+#define BENCH_CHUNK_BYTES            16384
+#define BENCH_CHUNK_PERIOD           7919
+
+/* Crypto service of the CMSIS-RTOS2 build (BENCH_RTOS): client threads at
+   most, requests per client, and blocks per bulk request */
+#define BENCH_RTOS_CLIENTS           4
+#define BENCH_RTOS_REQUESTS          64
+#define BENCH_RTOS_BLOCKS            32
+
+/* Random workload (BENCH_RANDOM): samples per cipher and input class, and
+   seed of the inputs. 0 draws a fresh seed from the RNG at every run, any
+   other value replays the run printed with it (make BENCH_SEED=0x...) */
+#define BENCH_RANDOM_SAMPLES         256
+#ifndef BENCH_SEED
+#define BENCH_SEED                   0
+#endif
+
+/* Stack measurement (BENCH_STACK): bytes of free stack painted below the
+   caller before every measured call */
+#define BENCH_STACK_PAINT            8192
+
+/* Exported macro ------------------------------------------------------------*/
+#define KIN1_InitCycleCounter() \
+KIN1_DEMCR |= KIN1_TRCENA_BIT
+/*!< TRCENA: Enable trace and debug block DEMCR (Debug Exception and Monitor Control Register */
+
+#define KIN1_ResetCycleCounter() \
+KIN1_DWT_CYCCNT = 0
+/*!< Reset cycle counter */
+
+#define KIN1_EnableCycleCounter() \
+KIN1_DWT_CONTROL |= KIN1_DWT_CYCCNTENA_BIT
+/*!< Enable cycle counter */
+
+#define KIN1_DisableCycleCounter() \
+KIN1_DWT_CONTROL &= ~KIN1_DWT_CYCCNTENA_BIT
+/*!< Disable cycle counter */
+
+#define KIN1_GetCycleCounter() \
+KIN1_DWT_CYCCNT
+/*!< Read cycle counter register */
+
+/* Exported functions ------------------------------------------------------- */
+void BENCH_printf(const char* format, ...);
+void BENCH_run(void);
+void BENCH_Timer_Callback(uint32_t counter);
+
+#endif /* __BENCHMARK_H */
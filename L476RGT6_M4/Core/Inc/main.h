@@ -32,6 +32,7 @@
 #include "stm32l4xx_ll_gpio.h"
 #include "stm32l4xx_ll_exti.h"
 #include "stm32l4xx_ll_usart.h"
+#include "stm32l4xx_ll_tim.h"
 
 /* Exported types ------------------------------------------------------------*/
 /* Exported constants --------------------------------------------------------*/
@@ -58,6 +59,27 @@
 #define USARTx_IRQn                      USART2_IRQn
 #define USARTx_IRQHandler                USART2_IRQHandler
 
+/* Definition for USARTx's DMA (BENCH_UART_DMA) */
+#define DMAx_CLK_ENABLE()                __HAL_RCC_DMA1_CLK_ENABLE()
+#define USARTx_TX_DMA_CHANNEL            DMA1_Channel7
+#define USARTx_RX_DMA_CHANNEL            DMA1_Channel6
+#define USARTx_TX_DMA_REQUEST            DMA_REQUEST_2
+#define USARTx_RX_DMA_REQUEST            DMA_REQUEST_2
+
+/* Definition for USARTx's DMA NVIC */
+#define USARTx_DMA_TX_IRQn               DMA1_Channel7_IRQn
+#define USARTx_DMA_RX_IRQn               DMA1_Channel6_IRQn
+#define USARTx_DMA_TX_IRQHandler         DMA1_Channel7_IRQHandler
+#define USARTx_DMA_RX_IRQHandler         DMA1_Channel6_IRQHandler
+
+/* Definition for the benchmark timer (BENCH_JOBS): 32-bit, free running at
+   the core clock, interrupts on compare channel 1 */
+#define BENCH_TIMx                       TIM2
+#define BENCH_TIMx_CLK_ENABLE()          __HAL_RCC_TIM2_CLK_ENABLE()
+#define BENCH_TIMx_CLK_DISABLE()         __HAL_RCC_TIM2_CLK_DISABLE()
+#define BENCH_TIMx_IRQn                  TIM2_IRQn
+#define BENCH_TIMx_IRQHandler            TIM2_IRQHandler
+
 /* Size of Reception buffer */
 #define RX_BUFFER_SIZE                   10
 
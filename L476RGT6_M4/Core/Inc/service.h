@@ -0,0 +1,56 @@
+/**
+  ******************************************************************************
+  * @file    service.h
+  * @brief   Crypto service thread of the CMSIS-RTOS2 build (USE_CMSIS_RTOS2): owns
+  *          the cipher contexts of the sessions and serves the requests of
+  *          the client threads through one message queue per priority class.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __SERVICE_H
+#define __SERVICE_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "config.h"
+#include "cipher.h"
+
+#ifdef USE_CMSIS_RTOS2
+
+/* Exported constants --------------------------------------------------------*/
+/* Priority classes: interactive requests are served before the queued bulk
+   requests and between the chunks of the bulk request in progress */
+#define SERVICE_INTERACTIVE          0
+#define SERVICE_BULK                 1
+
+#define SERVICE_ENCRYPT              0
+#define SERVICE_DECRYPT              1
+
+/* Sessions open at the same time (one cipher context each) */
+#define SERVICE_SESSIONS             4
+
+/* Requests waiting per priority class */
+#define SERVICE_QUEUE_SIZE           8
+
+/* Blocks of a bulk request processed between two looks at the interactive
+   queue (chunked.h) */
+#define SERVICE_CHUNK_BLOCKS         8
+
+/* Thread flag set on the client when its request is served */
+#define SERVICE_FLAG_DONE            0x0001U
+
+/* Exported functions ------------------------------------------------------- */
+/* Creates the queues and the service thread, after osKernelInitialize */
+void SERVICE_init(void);
+
+/* Client side, from threads only: every call blocks until the request is
+   served. A session is a cipher context expanded by the service thread */
+int32_t SERVICE_open(const BlockCipher* cipher, const uint32_t* key);
+int32_t SERVICE_crypt(int32_t session, uint8_t direction, uint8_t priority,
+                      const uint32_t* in, uint32_t* out, uint32_t nrBlocks);
+int32_t SERVICE_close(int32_t session);
+
+#endif /* USE_CMSIS_RTOS2 */
+
+#endif /* __SERVICE_H */
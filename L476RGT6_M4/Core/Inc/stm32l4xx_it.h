@@ -42,6 +42,9 @@ void DebugMon_Handler(void);
 void PendSV_Handler(void);
 void SysTick_Handler(void);
 void USARTx_IRQHandler(void);
+void USARTx_DMA_RX_IRQHandler(void);
+void USARTx_DMA_TX_IRQHandler(void);
+void BENCH_TIMx_IRQHandler(void);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,2091 @@
+/**
+  ******************************************************************************
+  * @file    benchmark.c
+  * @brief   Benchmark modes of the cipher harness. The mode is selected with
+  *          BENCHMARK in config.h and every result is printed on the UART
+  *          as one CSV line, preceded by a header line.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include "benchmark.h"
+#include "cipher.h"
+#include "CTR.h"
+#include "CBC.h"
+#include "GCM.h"
+#include "CMAC.h"
+#include "XTS.h"
+#include "stream.h"
+#include "jobqueue.h"
+#include "chunked.h"
+#ifdef USE_CMSIS_RTOS2
+#include "cmsis_os2.h"
+#include "service.h"
+#endif
+
+/* Private define ------------------------------------------------------------*/
+/* Jobs of the load generator: twice the queue, so the job reused by a
+   submission has always completed */
+#define JOB_POOL                     (2 * JOBQ_SIZE)
+#define JOB_WORDS(cipher)            (BENCH_JOB_BLOCKS * (cipher)->blockWords)
+
+/* Fill of the free stack, words still holding it were never touched */
+#define STACK_PATTERN                0xC5C5C5C5
+
+#ifdef USE_CMSIS_RTOS2
+/* Thread flag of a service client when done, above SERVICE_FLAG_DONE that
+   the same thread waits for in SERVICE_open and SERVICE_close */
+#define CLIENT_FLAG(index)           (SERVICE_FLAG_DONE << (1 + (index)))
+#endif
+
+/* Private typedef -----------------------------------------------------------*/
+/* One operating point of the clock sweep */
+typedef struct
+{
+  const char* source;
+  uint32_t msiRange;   /* MSI frequency, the PLL input when pll is set */
+  uint8_t pll;         /* SYSCLK = MSI * PLLN / PLLR instead of MSI */
+  uint32_t pllN;
+  uint32_t latency;    /* flash wait states */
+} ClockPoint;
+
+#ifdef USE_CMSIS_RTOS2
+/* One client thread of the crypto service */
+typedef struct
+{
+  uint8_t priority;            /* SERVICE_INTERACTIVE or SERVICE_BULK */
+  uint32_t nrBlocks;
+  int32_t session;
+  const uint32_t* in;
+  uint32_t* out;
+  uint32_t latency[BENCH_RTOS_REQUESTS];  /* cycles of every request */
+} ServiceClient;
+#endif
+
+/* Private variables ---------------------------------------------------------*/
+extern UART_HandleTypeDef UartHandle;
+extern JobQueue cryptoJobs;
+
+/* Hardware random number generator, seeds of the random workload */
+RNG_HandleTypeDef RngHandle;
+
+/* Test vectors from constants.h (defined in main.c) */
+extern uint32_t NONCE_LIST[];
+extern uint32_t TEXT_LIST[];
+extern uint32_t KEY[];
+
+/* Legacy entry point of the selected cipher (BENCH_CRYPT_MAIN) */
+int crypt_main(uint32_t* text, uint32_t* key);
+
+/* Linker script symbols: initialised and zeroed data, SRAM2 sections, end
+   of the static RAM (start of the heap) and the heap and stack reserves */
+extern uint8_t _sdata, _edata, _sbss, _ebss, _ssram2, _esram2, _end;
+extern uint8_t _Min_Heap_Size, _Min_Stack_Size;
+
+static uint32_t cipherText[BENCH_WORDS];
+static uint32_t decryptedText[BENCH_WORDS];
+
+static CipherContext cipherContext;
+static CtrContext ctrContext;
+static GcmContext gcmContext;
+static CmacContext cmacContext;
+static CipherContext tweakContext;
+static XtsContext xtsContext;
+
+/* Largest XTS sector */
+static uint32_t sectorBuffer[4096 / 4];
+
+static StreamContext streamContext;
+
+/* Padded streaming output: the data plus one block */
+static uint8_t streamOut[4 * (BENCH_WORDS + MAX_BLOCK_WORDS)];
+
+/* DMA UART pipeline: circular reception buffer, one chunk per half, and
+   one transmission buffer per half so a chunk is encrypted while the
+   previous one is sent */
+static uint8_t dmaRxBuffer[2 * UART_DMA_CHUNK];
+static uint8_t dmaTxBuffer[2][UART_DMA_CHUNK];
+static volatile uint32_t rxChunks;   /* halves filled by the DMA */
+static volatile uint32_t rxTick[2];  /* cycle counter when each half was filled */
+static volatile uint8_t txBusy;
+
+/* Benchmark timer: compare period in cycles, run at every compare, and
+   latency of its interrupt (cycles from the compare match to the handler) */
+static volatile uint32_t timerPeriod;
+static void (*volatile timerHook)(void);
+static volatile uint32_t timerEvents;
+static volatile uint32_t timerLatencySum;
+static volatile uint32_t timerLatencyMax;
+
+/* Job load generator (timer interrupt) and completion statistics (PendSV) */
+static CryptoJob jobPool[JOB_POOL];
+static volatile uint32_t jobsSubmitted;
+static volatile uint32_t jobsRejected;
+static volatile uint32_t jobsCompleted;
+static volatile uint32_t jobsQueueCycles;
+static volatile uint32_t jobsMaxQueueCycles;
+static volatile uint32_t jobsProcessCycles;
+static volatile uint32_t jobsLastFinished;
+static volatile uint8_t jobsLoading;
+static uint32_t loadStart;
+
+/* Long buffer of the chunked encryption, processed in place */
+static uint32_t chunkBuffer[BENCH_CHUNK_BYTES / 4];
+static ChunkedContext chunkedContext;
+
+#ifdef USE_CMSIS_RTOS2
+/* Crypto service clients, the thread waiting for them, and the latencies
+   of one priority class sorted for the percentiles */
+static ServiceClient serviceClients[BENCH_RTOS_CLIENTS];
+static osThreadId_t clientsOwner;
+static uint32_t latencySamples[BENCH_RTOS_CLIENTS * BENCH_RTOS_REQUESTS];
+#endif
+
+/* Random workload: state of the generator expanding the seed, and the
+   cycles of every sample sorted for the percentiles */
+static uint32_t workloadState;
+static uint32_t setupSamples[BENCH_RANDOM_SAMPLES];
+static uint32_t encryptSamples[BENCH_RANDOM_SAMPLES];
+
+/* Lowest word of the painted stack */
+static uint32_t* stackBottom;
+
+/* Clock sweep, each frequency with the smallest flash latency allowed in
+   voltage range 1 (RM0351 3.3.3), plus 16 MHz with the 4 wait states of
+   80 MHz; the last point is the configuration of SystemClock_Config */
+static const ClockPoint clockPoints[] =
+{
+  { "MSI", RCC_MSIRANGE_8,  0, 0,  FLASH_LATENCY_0 },
+  { "MSI", RCC_MSIRANGE_8,  0, 0,  FLASH_LATENCY_4 },
+  { "MSI", RCC_MSIRANGE_9,  0, 0,  FLASH_LATENCY_1 },
+  { "MSI", RCC_MSIRANGE_11, 0, 0,  FLASH_LATENCY_2 },
+  { "PLL", RCC_MSIRANGE_6,  1, 40, FLASH_LATENCY_4 },
+};
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  printf to the UART (blocking)
+  * @retval None
+  */
+void BENCH_printf(const char* format, ...)
+{
+  char line[160];
+  va_list args;
+
+  va_start(args, format);
+  vsnprintf(line, sizeof(line), format, args);
+  va_end(args);
+
+  HAL_UART_Transmit(&UartHandle, (uint8_t*)line, strlen(line), 1000);
+}
+
+/**
+  * @brief  Format cycles/bytes with two decimals (printf has no float support
+  *         with nano.specs)
+  * @retval The string passed in
+  */
+static char* cyclesPerByte(char* s, uint32_t cycles, uint32_t bytes)
+{
+  uint32_t hundredths = (uint32_t)(((uint64_t)cycles * 100 + bytes / 2) / bytes);
+
+  sprintf(s, "%lu.%02lu", hundredths / 100, hundredths % 100);
+  return s;
+}
+
+/**
+  * @brief  ECB over BENCH_WORDS words of TEXT_LIST for every registered cipher.
+  *         Key setup, encryption and decryption are timed separately and
+  *         averaged over BENCH_RUNS runs; the decryption is checked against
+  *         the plaintext.
+  * @retval None
+  */
+static void BENCH_ecb(void)
+{
+  CipherContext context;
+  const BlockCipher* cipher;
+  uint32_t nrBlocks;
+  uint32_t tick, setup, enc, dec;
+  uint32_t i, run;
+  char encCpb[16], decCpb[16];
+
+  BENCH_printf("cipher,key_bits,block_bytes,setup_cycles,enc_cycles,dec_cycles,bytes,enc_cpb,dec_cpb,check\n\r");
+
+  for (i = 0; i < NR_CIPHERS; i++)
+  {
+    cipher = CIPHERS[i];
+    nrBlocks = BENCH_WORDS / cipher->blockWords;
+    setup = enc = dec = 0;
+
+    for (run = 0; run < BENCH_RUNS; run++)
+    {
+      tick = KIN1_GetCycleCounter();
+      cipher->init(&context, KEY, cipher->keyLen);
+      setup += KIN1_GetCycleCounter() - tick;
+
+      tick = KIN1_GetCycleCounter();
+      cipher->encrypt(&context, TEXT_LIST, cipherText, nrBlocks);
+      enc += KIN1_GetCycleCounter() - tick;
+
+      tick = KIN1_GetCycleCounter();
+      cipher->decrypt(&context, cipherText, decryptedText, nrBlocks);
+      dec += KIN1_GetCycleCounter() - tick;
+    }
+
+    BENCH_printf("%s,%u,%u,%lu,%lu,%lu,%u,%s,%s,%s\n\r",
+                 cipher->name, cipher->keyLen, 4 * cipher->blockWords,
+                 setup / BENCH_RUNS, enc / BENCH_RUNS, dec / BENCH_RUNS, 4 * BENCH_WORDS,
+                 cyclesPerByte(encCpb, enc / BENCH_RUNS, 4 * BENCH_WORDS),
+                 cyclesPerByte(decCpb, dec / BENCH_RUNS, 4 * BENCH_WORDS),
+                 memcmp(decryptedText, TEXT_LIST, sizeof(decryptedText)) ? "FAIL" : "ok");
+  }
+}
+
+/**
+  * @brief  CTR mode over one keystream buffer (CTR_KEYSTREAM_WORDS words) for
+  *         every registered cipher, with a new nonce from NONCE_LIST per run.
+  *         offline: CTR_prefill, the cipher work done ahead of time
+  *         online: CTR_crypt of the data on the prefilled keystream (XOR only)
+  *         ondemand: CTR_crypt without prefill, keystream generated in the call
+  *         The ondemand pass decrypts the online ciphertext for the check.
+  * @retval None
+  */
+static void BENCH_ctr(void)
+{
+  const BlockCipher* cipher;
+  uint32_t* nonce;
+  uint32_t tick, offline, online, ondemand;
+  uint32_t i, run;
+  char onlineCpb[16], ondemandCpb[16];
+
+  BENCH_printf("cipher,key_bits,block_bytes,bytes,offline_cycles,online_cycles,ondemand_cycles,online_cpb,ondemand_cpb,check\n\r");
+
+  for (i = 0; i < NR_CIPHERS; i++)
+  {
+    cipher = CIPHERS[i];
+    cipher->init(&cipherContext, KEY, cipher->keyLen);
+    offline = online = ondemand = 0;
+
+    for (run = 0; run < BENCH_RUNS; run++)
+    {
+      nonce = &NONCE_LIST[run * cipher->blockWords];
+
+      CTR_init(&ctrContext, cipher, &cipherContext, nonce);
+      tick = KIN1_GetCycleCounter();
+      CTR_prefill(&ctrContext);
+      offline += KIN1_GetCycleCounter() - tick;
+
+      tick = KIN1_GetCycleCounter();
+      CTR_crypt(&ctrContext, TEXT_LIST, cipherText, CTR_KEYSTREAM_WORDS);
+      online += KIN1_GetCycleCounter() - tick;
+
+      CTR_init(&ctrContext, cipher, &cipherContext, nonce);
+      tick = KIN1_GetCycleCounter();
+      CTR_crypt(&ctrContext, cipherText, decryptedText, CTR_KEYSTREAM_WORDS);
+      ondemand += KIN1_GetCycleCounter() - tick;
+    }
+
+    BENCH_printf("%s,%u,%u,%u,%lu,%lu,%lu,%s,%s,%s\n\r",
+                 cipher->name, cipher->keyLen, 4 * cipher->blockWords, 4 * CTR_KEYSTREAM_WORDS,
+                 offline / BENCH_RUNS, online / BENCH_RUNS, ondemand / BENCH_RUNS,
+                 cyclesPerByte(onlineCpb, online / BENCH_RUNS, 4 * CTR_KEYSTREAM_WORDS),
+                 cyclesPerByte(ondemandCpb, ondemand / BENCH_RUNS, 4 * CTR_KEYSTREAM_WORDS),
+                 memcmp(decryptedText, TEXT_LIST, 4 * CTR_KEYSTREAM_WORDS) ? "FAIL" : "ok");
+  }
+}
+
+/**
+  * @brief  CBC mode over BENCH_WORDS words of TEXT_LIST for every registered
+  *         cipher, with the IV taken from NONCE_LIST. Decryption hands
+  *         CBC_DECRYPT_BLOCKS blocks per call to the cipher.
+  * @retval None
+  */
+static void BENCH_cbc(void)
+{
+  const BlockCipher* cipher;
+  uint32_t iv[MAX_BLOCK_WORDS];
+  uint32_t nrBlocks;
+  uint32_t tick, enc, dec;
+  uint32_t i, run;
+  char encCpb[16], decCpb[16];
+
+  BENCH_printf("cipher,key_bits,block_bytes,bytes,enc_cycles,dec_cycles,enc_cpb,dec_cpb,check\n\r");
+
+  for (i = 0; i < NR_CIPHERS; i++)
+  {
+    cipher = CIPHERS[i];
+    cipher->init(&cipherContext, KEY, cipher->keyLen);
+    nrBlocks = BENCH_WORDS / cipher->blockWords;
+    enc = dec = 0;
+
+    for (run = 0; run < BENCH_RUNS; run++)
+    {
+      memcpy(iv, &NONCE_LIST[run * cipher->blockWords], sizeof(iv));
+      tick = KIN1_GetCycleCounter();
+      CBC_encrypt(cipher, &cipherContext, iv, TEXT_LIST, cipherText, nrBlocks);
+      enc += KIN1_GetCycleCounter() - tick;
+
+      memcpy(iv, &NONCE_LIST[run * cipher->blockWords], sizeof(iv));
+      tick = KIN1_GetCycleCounter();
+      CBC_decrypt(cipher, &cipherContext, iv, cipherText, decryptedText, nrBlocks);
+      dec += KIN1_GetCycleCounter() - tick;
+    }
+
+    BENCH_printf("%s,%u,%u,%u,%lu,%lu,%s,%s,%s\n\r",
+                 cipher->name, cipher->keyLen, 4 * cipher->blockWords, 4 * BENCH_WORDS,
+                 enc / BENCH_RUNS, dec / BENCH_RUNS,
+                 cyclesPerByte(encCpb, enc / BENCH_RUNS, 4 * BENCH_WORDS),
+                 cyclesPerByte(decCpb, dec / BENCH_RUNS, 4 * BENCH_WORDS),
+                 memcmp(decryptedText, TEXT_LIST, sizeof(decryptedText)) ? "FAIL" : "ok");
+  }
+}
+
+/**
+  * @brief  GCM over BENCH_WORDS words of TEXT_LIST with 16 bytes of AAD for
+  *         every registered cipher with a 128 bits block, once with the
+  *         table GHASH and once with the constant-time one. The raw cipher
+  *         (ECB over the same data) and GHASH alone are timed next to seal
+  *         and open, to split the AEAD cost between cipher and GHASH.
+  * @retval None
+  */
+static void BENCH_gcm(void)
+{
+  const BlockCipher* cipher;
+  const uint32_t* iv;
+  const uint32_t* aad = &NONCE_LIST[4 * BENCH_RUNS];
+  uint32_t tag[GCM_TAG_WORDS];
+  uint32_t tick, raw, ghash, seal, open;
+  uint32_t i, run;
+  uint8_t constantTime;
+  int failed;
+  char sealCpb[16], openCpb[16];
+
+  BENCH_printf("cipher,key_bits,ghash,bytes,cipher_cycles,ghash_cycles,seal_cycles,open_cycles,seal_cpb,open_cpb,check\n\r");
+
+  for (i = 0; i < NR_CIPHERS; i++)
+  {
+    cipher = CIPHERS[i];
+    if (cipher->blockWords != 4)
+    {
+      continue;
+    }
+    cipher->init(&cipherContext, KEY, cipher->keyLen);
+
+    for (constantTime = 0; constantTime <= 1; constantTime++)
+    {
+      GCM_init(&gcmContext, cipher, &cipherContext, constantTime);
+      raw = ghash = seal = open = 0;
+      failed = 0;
+
+      for (run = 0; run < BENCH_RUNS; run++)
+      {
+        iv = &NONCE_LIST[4 * run];
+
+        tick = KIN1_GetCycleCounter();
+        cipher->encrypt(&cipherContext, TEXT_LIST, cipherText, BENCH_WORDS / 4);
+        raw += KIN1_GetCycleCounter() - tick;
+
+        tick = KIN1_GetCycleCounter();
+        GCM_ghash(&gcmContext, TEXT_LIST, BENCH_WORDS);
+        ghash += KIN1_GetCycleCounter() - tick;
+
+        tick = KIN1_GetCycleCounter();
+        GCM_encrypt(&gcmContext, iv, aad, 4, TEXT_LIST, cipherText, BENCH_WORDS, tag);
+        seal += KIN1_GetCycleCounter() - tick;
+
+        tick = KIN1_GetCycleCounter();
+        failed |= GCM_decrypt(&gcmContext, iv, aad, 4, cipherText, decryptedText, BENCH_WORDS, tag);
+        open += KIN1_GetCycleCounter() - tick;
+      }
+
+      BENCH_printf("%s,%u,%s,%u,%lu,%lu,%lu,%lu,%s,%s,%s\n\r",
+                   cipher->name, cipher->keyLen, constantTime ? "ct" : "table", 4 * BENCH_WORDS,
+                   raw / BENCH_RUNS, ghash / BENCH_RUNS, seal / BENCH_RUNS, open / BENCH_RUNS,
+                   cyclesPerByte(sealCpb, seal / BENCH_RUNS, 4 * BENCH_WORDS),
+                   cyclesPerByte(openCpb, open / BENCH_RUNS, 4 * BENCH_WORDS),
+                   (failed || memcmp(decryptedText, TEXT_LIST, sizeof(decryptedText))) ? "FAIL" : "ok");
+    }
+  }
+}
+
+/**
+  * @brief  CMAC of every registered cipher over the first bytes of the flash
+  *         (the firmware image), for messages of 16 B to 4 KB. The check
+  *         compares with the MAC of the same message fed in RX_BUFFER_SIZE
+  *         byte pieces.
+  * @retval None
+  */
+static void BENCH_cmac(void)
+{
+  static const uint32_t sizes[] = { 16, 64, 256, 1024, 4096 };
+  const uint8_t* message = (const uint8_t*)FLASH_BASE;
+  const BlockCipher* cipher;
+  uint8_t mac[4 * MAX_BLOCK_WORDS];
+  uint8_t check[4 * MAX_BLOCK_WORDS];
+  uint32_t tick, subkeys, cycles;
+  uint32_t i, j, k, run;
+  char cpb[16];
+
+  BENCH_printf("cipher,key_bits,block_bytes,subkey_cycles,bytes,mac_cycles,cpb,check\n\r");
+
+  for (i = 0; i < NR_CIPHERS; i++)
+  {
+    cipher = CIPHERS[i];
+    cipher->init(&cipherContext, KEY, cipher->keyLen);
+
+    subkeys = 0;
+    for (run = 0; run < BENCH_RUNS; run++)
+    {
+      tick = KIN1_GetCycleCounter();
+      CMAC_init(&cmacContext, cipher, &cipherContext);
+      subkeys += KIN1_GetCycleCounter() - tick;
+    }
+
+    for (j = 0; j < sizeof(sizes) / sizeof(sizes[0]); j++)
+    {
+      cycles = 0;
+      for (run = 0; run < BENCH_RUNS; run++)
+      {
+        tick = KIN1_GetCycleCounter();
+        CMAC_update(&cmacContext, message, sizes[j]);
+        CMAC_final(&cmacContext, mac);
+        cycles += KIN1_GetCycleCounter() - tick;
+      }
+
+      for (k = 0; k < sizes[j]; k += RX_BUFFER_SIZE)
+      {
+        CMAC_update(&cmacContext, message + k, (sizes[j] - k < RX_BUFFER_SIZE) ? sizes[j] - k : RX_BUFFER_SIZE);
+      }
+      CMAC_final(&cmacContext, check);
+
+      BENCH_printf("%s,%u,%u,%lu,%lu,%lu,%s,%s\n\r",
+                   cipher->name, cipher->keyLen, 4 * cipher->blockWords, subkeys / BENCH_RUNS,
+                   sizes[j], cycles / BENCH_RUNS,
+                   cyclesPerByte(cpb, cycles / BENCH_RUNS, sizes[j]),
+                   memcmp(mac, check, 4 * cipher->blockWords) ? "FAIL" : "ok");
+    }
+  }
+}
+
+/**
+  * @brief  XTS of every registered cipher with a 128 bits block on 512 B and
+  *         4 KB sectors of the flash content; the tweak key is taken from
+  *         NONCE_LIST. Sectors per second are given at the current
+  *         SystemCoreClock. The sector is decrypted in place for the check.
+  * @retval None
+  */
+static void BENCH_xts(void)
+{
+  static const uint32_t sizes[] = { 512, 4096 };
+  const uint32_t* sectorData = (const uint32_t*)FLASH_BASE;
+  const BlockCipher* cipher;
+  uint32_t tick, enc, dec;
+  uint32_t i, j, run;
+
+  BENCH_printf("cipher,key_bits,sector_bytes,enc_cycles,dec_cycles,enc_sectors_per_s,dec_sectors_per_s,check\n\r");
+
+  for (i = 0; i < NR_CIPHERS; i++)
+  {
+    cipher = CIPHERS[i];
+    if (cipher->blockWords != 4)
+    {
+      continue;
+    }
+    cipher->init(&cipherContext, KEY, cipher->keyLen);
+    cipher->init(&tweakContext, NONCE_LIST, cipher->keyLen);
+    XTS_init(&xtsContext, cipher, &cipherContext, &tweakContext);
+
+    for (j = 0; j < sizeof(sizes) / sizeof(sizes[0]); j++)
+    {
+      enc = dec = 0;
+      for (run = 0; run < BENCH_RUNS; run++)
+      {
+        tick = KIN1_GetCycleCounter();
+        XTS_encrypt_sector(&xtsContext, run, sectorData, sectorBuffer, sizes[j]);
+        enc += KIN1_GetCycleCounter() - tick;
+
+        tick = KIN1_GetCycleCounter();
+        XTS_decrypt_sector(&xtsContext, run, sectorBuffer, sectorBuffer, sizes[j]);
+        dec += KIN1_GetCycleCounter() - tick;
+      }
+
+      BENCH_printf("%s,%u,%lu,%lu,%lu,%lu,%lu,%s\n\r",
+                   cipher->name, cipher->keyLen, sizes[j], enc / BENCH_RUNS, dec / BENCH_RUNS,
+                   SystemCoreClock / (enc / BENCH_RUNS), SystemCoreClock / (dec / BENCH_RUNS),
+                   memcmp(sectorBuffer, sectorData, sizes[j]) ? "FAIL" : "ok");
+    }
+  }
+}
+
+/**
+  * @brief  Feed len bytes to the stream in pieces of at most piece bytes,
+  *         as they would arrive from the UART.
+  * @retval Bytes written to out, -1 on a padding error
+  */
+static int32_t streamPieces(const uint8_t* in, uint32_t len, uint8_t* out, uint32_t piece)
+{
+  uint32_t written = 0;
+  uint32_t n;
+  int32_t last;
+
+  for (; len > 0; len -= n)
+  {
+    n = len < piece ? len : piece;
+    written += STREAM_update(&streamContext, in, n, out + written);
+    in += n;
+  }
+
+  last = STREAM_final(&streamContext, out + written);
+  return (last < 0) ? -1 : (int32_t)written + last;
+}
+
+/**
+  * @brief  Streaming ECB over the BENCH_WORDS words of TEXT_LIST taken as
+  *         bytes, for every registered cipher: encryption in a single
+  *         update and in RX_BUFFER_SIZE byte updates, decryption in
+  *         RX_BUFFER_SIZE byte updates, checked against the plaintext.
+  * @retval None
+  */
+static void BENCH_stream(void)
+{
+  const uint8_t* plainText = (const uint8_t*)TEXT_LIST;
+  const BlockCipher* cipher;
+  uint32_t tick, whole, pieces, dec;
+  uint32_t i, run;
+  int32_t len = 0;
+  char wholeCpb[16], piecesCpb[16], decCpb[16];
+
+  BENCH_printf("cipher,key_bits,block_bytes,bytes,enc_cycles,enc_pieces_cycles,dec_pieces_cycles,enc_cpb,enc_pieces_cpb,dec_pieces_cpb,check\n\r");
+
+  for (i = 0; i < NR_CIPHERS; i++)
+  {
+    cipher = CIPHERS[i];
+    cipher->init(&cipherContext, KEY, cipher->keyLen);
+    whole = pieces = dec = 0;
+
+    for (run = 0; run < BENCH_RUNS; run++)
+    {
+      STREAM_init(&streamContext, cipher, &cipherContext, STREAM_ENCRYPT);
+      tick = KIN1_GetCycleCounter();
+      streamPieces(plainText, 4 * BENCH_WORDS, streamOut, 4 * BENCH_WORDS);
+      whole += KIN1_GetCycleCounter() - tick;
+
+      STREAM_init(&streamContext, cipher, &cipherContext, STREAM_ENCRYPT);
+      tick = KIN1_GetCycleCounter();
+      len = streamPieces(plainText, 4 * BENCH_WORDS, streamOut, RX_BUFFER_SIZE);
+      pieces += KIN1_GetCycleCounter() - tick;
+
+      STREAM_init(&streamContext, cipher, &cipherContext, STREAM_DECRYPT);
+      tick = KIN1_GetCycleCounter();
+      len = streamPieces(streamOut, len, (uint8_t*)decryptedText, RX_BUFFER_SIZE);
+      dec += KIN1_GetCycleCounter() - tick;
+    }
+
+    BENCH_printf("%s,%u,%u,%u,%lu,%lu,%lu,%s,%s,%s,%s\n\r",
+                 cipher->name, cipher->keyLen, 4 * cipher->blockWords, 4 * BENCH_WORDS,
+                 whole / BENCH_RUNS, pieces / BENCH_RUNS, dec / BENCH_RUNS,
+                 cyclesPerByte(wholeCpb, whole / BENCH_RUNS, 4 * BENCH_WORDS),
+                 cyclesPerByte(piecesCpb, pieces / BENCH_RUNS, 4 * BENCH_WORDS),
+                 cyclesPerByte(decCpb, dec / BENCH_RUNS, 4 * BENCH_WORDS),
+                 (len != 4 * BENCH_WORDS || memcmp(decryptedText, TEXT_LIST, sizeof(decryptedText))) ? "FAIL" : "ok");
+  }
+}
+
+/**
+  * @brief  ECB over the BENCH_WORDS words of TEXT_LIST for every registered
+  *         cipher through the word API and through the byte API, with
+  *         aligned buffers and with buffers one byte off; repack is the
+  *         conversion of the buffer to words and back without the cipher.
+  * @retval None
+  */
+static void BENCH_bytes(void)
+{
+  const uint8_t* plainText = (const uint8_t*)TEXT_LIST;
+  const BlockCipher* cipher;
+  uint32_t nrBlocks;
+  uint32_t tick, words, bytes, unaligned, repack;
+  uint32_t i, run;
+  int failed;
+
+  BENCH_printf("cipher,key_bits,block_bytes,bytes,word_cycles,byte_cycles,byte_unaligned_cycles,repack_cycles,check\n\r");
+
+  for (i = 0; i < NR_CIPHERS; i++)
+  {
+    cipher = CIPHERS[i];
+    cipher->init(&cipherContext, KEY, cipher->keyLen);
+    nrBlocks = BENCH_WORDS / cipher->blockWords;
+    words = bytes = unaligned = repack = 0;
+
+    for (run = 0; run < BENCH_RUNS; run++)
+    {
+      tick = KIN1_GetCycleCounter();
+      cipher->encrypt(&cipherContext, TEXT_LIST, cipherText, nrBlocks);
+      words += KIN1_GetCycleCounter() - tick;
+
+      tick = KIN1_GetCycleCounter();
+      CIPHER_encrypt_bytes(cipher, &cipherContext, plainText, streamOut, nrBlocks);
+      bytes += KIN1_GetCycleCounter() - tick;
+
+      tick = KIN1_GetCycleCounter();
+      CIPHER_encrypt_bytes(cipher, &cipherContext, plainText + 1, streamOut + 1, nrBlocks);
+      unaligned += KIN1_GetCycleCounter() - tick;
+
+      tick = KIN1_GetCycleCounter();
+      CIPHER_load_words(plainText, decryptedText, BENCH_WORDS);
+      CIPHER_store_words(decryptedText, streamOut, BENCH_WORDS);
+      repack += KIN1_GetCycleCounter() - tick;
+    }
+
+    /* the unaligned ciphertext decrypts back in place to the plaintext */
+    CIPHER_encrypt_bytes(cipher, &cipherContext, plainText + 1, streamOut + 1, nrBlocks);
+    CIPHER_decrypt_bytes(cipher, &cipherContext, streamOut + 1, streamOut + 1, nrBlocks);
+    failed = memcmp(streamOut + 1, plainText + 1, 4 * BENCH_WORDS);
+
+    BENCH_printf("%s,%u,%u,%u,%lu,%lu,%lu,%lu,%s\n\r",
+                 cipher->name, cipher->keyLen, 4 * cipher->blockWords, 4 * BENCH_WORDS,
+                 words / BENCH_RUNS, bytes / BENCH_RUNS, unaligned / BENCH_RUNS, repack / BENCH_RUNS,
+                 failed ? "FAIL" : "ok");
+  }
+}
+
+/**
+  * @brief  Check every block and bulk API of a registered cipher with out == in
+  *         against the same call with separate buffers: one block and the
+  *         whole buffer through the word and byte APIs, CBC, CTR and the
+  *         streaming layer (output trailing the input in RX_BUFFER_SIZE byte
+  *         updates), plus GCM and XTS for the 128 bits blocks. cipherContext
+  *         holds the expanded key.
+  * @retval 0 when every in place result matches, 1 otherwise
+  */
+static int inPlaceCheck(const BlockCipher* cipher)
+{
+  const uint8_t* plainText = (const uint8_t*)TEXT_LIST;
+  uint32_t blockBytes = 4 * cipher->blockWords;
+  uint32_t nrBlocks = BENCH_WORDS / cipher->blockWords;
+  uint32_t iv[MAX_BLOCK_WORDS];
+  uint32_t tag[GCM_TAG_WORDS], check[GCM_TAG_WORDS];
+  int failed = 0;
+
+  /* one block */
+  cipher->encrypt(&cipherContext, TEXT_LIST, cipherText, 1);
+  memcpy(decryptedText, TEXT_LIST, blockBytes);
+  cipher->encrypt(&cipherContext, decryptedText, decryptedText, 1);
+  failed |= memcmp(decryptedText, cipherText, blockBytes);
+  cipher->decrypt(&cipherContext, decryptedText, decryptedText, 1);
+  failed |= memcmp(decryptedText, TEXT_LIST, blockBytes);
+
+  /* whole buffer, word API */
+  cipher->encrypt(&cipherContext, TEXT_LIST, cipherText, nrBlocks);
+  memcpy(decryptedText, TEXT_LIST, sizeof(decryptedText));
+  cipher->encrypt(&cipherContext, decryptedText, decryptedText, nrBlocks);
+  failed |= memcmp(decryptedText, cipherText, sizeof(decryptedText));
+  cipher->decrypt(&cipherContext, decryptedText, decryptedText, nrBlocks);
+  failed |= memcmp(decryptedText, TEXT_LIST, sizeof(decryptedText));
+
+  /* whole buffer, byte API */
+  CIPHER_encrypt_bytes(cipher, &cipherContext, plainText, (uint8_t*)cipherText, nrBlocks);
+  memcpy(decryptedText, TEXT_LIST, sizeof(decryptedText));
+  CIPHER_encrypt_bytes(cipher, &cipherContext, (uint8_t*)decryptedText, (uint8_t*)decryptedText, nrBlocks);
+  failed |= memcmp(decryptedText, cipherText, sizeof(decryptedText));
+  CIPHER_decrypt_bytes(cipher, &cipherContext, (uint8_t*)decryptedText, (uint8_t*)decryptedText, nrBlocks);
+  failed |= memcmp(decryptedText, TEXT_LIST, sizeof(decryptedText));
+
+  /* streaming, same ECB ciphertext as the byte API plus the padding block */
+  memcpy(streamOut, TEXT_LIST, 4 * BENCH_WORDS);
+  STREAM_init(&streamContext, cipher, &cipherContext, STREAM_ENCRYPT);
+  failed |= streamPieces(streamOut, 4 * BENCH_WORDS, streamOut, RX_BUFFER_SIZE) != 4 * BENCH_WORDS + blockBytes;
+  failed |= memcmp(streamOut, cipherText, sizeof(cipherText));
+  STREAM_init(&streamContext, cipher, &cipherContext, STREAM_DECRYPT);
+  failed |= streamPieces(streamOut, 4 * BENCH_WORDS + blockBytes, streamOut, RX_BUFFER_SIZE) != 4 * BENCH_WORDS;
+  failed |= memcmp(streamOut, TEXT_LIST, 4 * BENCH_WORDS);
+
+  /* CBC */
+  memcpy(iv, NONCE_LIST, blockBytes);
+  CBC_encrypt(cipher, &cipherContext, iv, TEXT_LIST, cipherText, nrBlocks);
+  memcpy(iv, NONCE_LIST, blockBytes);
+  memcpy(decryptedText, TEXT_LIST, sizeof(decryptedText));
+  CBC_encrypt(cipher, &cipherContext, iv, decryptedText, decryptedText, nrBlocks);
+  failed |= memcmp(decryptedText, cipherText, sizeof(decryptedText));
+  memcpy(iv, NONCE_LIST, blockBytes);
+  CBC_decrypt(cipher, &cipherContext, iv, decryptedText, decryptedText, nrBlocks);
+  failed |= memcmp(decryptedText, TEXT_LIST, sizeof(decryptedText));
+
+  /* CTR */
+  CTR_init(&ctrContext, cipher, &cipherContext, NONCE_LIST);
+  CTR_crypt(&ctrContext, TEXT_LIST, cipherText, BENCH_WORDS);
+  memcpy(decryptedText, TEXT_LIST, sizeof(decryptedText));
+  CTR_init(&ctrContext, cipher, &cipherContext, NONCE_LIST);
+  CTR_crypt(&ctrContext, decryptedText, decryptedText, BENCH_WORDS);
+  failed |= memcmp(decryptedText, cipherText, sizeof(decryptedText));
+  CTR_init(&ctrContext, cipher, &cipherContext, NONCE_LIST);
+  CTR_crypt(&ctrContext, decryptedText, decryptedText, BENCH_WORDS);
+  failed |= memcmp(decryptedText, TEXT_LIST, sizeof(decryptedText));
+
+  if (cipher->blockWords == 4)
+  {
+    /* GCM, the tag is over the ciphertext either way */
+    GCM_init(&gcmContext, cipher, &cipherContext, 0);
+    GCM_encrypt(&gcmContext, NONCE_LIST, KEY, 4, TEXT_LIST, cipherText, BENCH_WORDS, check);
+    memcpy(decryptedText, TEXT_LIST, sizeof(decryptedText));
+    GCM_encrypt(&gcmContext, NONCE_LIST, KEY, 4, decryptedText, decryptedText, BENCH_WORDS, tag);
+    failed |= memcmp(decryptedText, cipherText, sizeof(decryptedText)) | memcmp(tag, check, sizeof(tag));
+    failed |= GCM_decrypt(&gcmContext, NONCE_LIST, KEY, 4, decryptedText, decryptedText, BENCH_WORDS, tag);
+    failed |= memcmp(decryptedText, TEXT_LIST, sizeof(decryptedText));
+
+    /* XTS, the whole buffer as one sector */
+    cipher->init(&tweakContext, NONCE_LIST, cipher->keyLen);
+    XTS_init(&xtsContext, cipher, &cipherContext, &tweakContext);
+    XTS_encrypt_sector(&xtsContext, 1, TEXT_LIST, cipherText, 4 * BENCH_WORDS);
+    memcpy(decryptedText, TEXT_LIST, sizeof(decryptedText));
+    XTS_encrypt_sector(&xtsContext, 1, decryptedText, decryptedText, 4 * BENCH_WORDS);
+    failed |= memcmp(decryptedText, cipherText, sizeof(decryptedText));
+    XTS_decrypt_sector(&xtsContext, 1, decryptedText, decryptedText, 4 * BENCH_WORDS);
+    failed |= memcmp(decryptedText, TEXT_LIST, sizeof(decryptedText));
+  }
+
+  return failed != 0;
+}
+
+/**
+  * @brief  ECB over the BENCH_WORDS words of TEXT_LIST for every registered
+  *         cipher with separate input and output buffers and in place
+  *         (out == in), through the word API and the byte API. The in place
+  *         buffer is decrypted back every run, so no copy is timed. The check
+  *         column is the result of inPlaceCheck.
+  * @retval None
+  */
+static void BENCH_inplace(void)
+{
+  const BlockCipher* cipher;
+  uint8_t* buffer = (uint8_t*)decryptedText;
+  uint32_t nrBlocks;
+  uint32_t tick, enc, encInPlace, dec, decInPlace, bytes, bytesInPlace;
+  uint32_t i, run;
+  char encCpb[16], encInPlaceCpb[16];
+
+  BENCH_printf("cipher,key_bits,block_bytes,bytes,enc_cycles,enc_inplace_cycles,dec_cycles,dec_inplace_cycles,"
+               "byte_cycles,byte_inplace_cycles,enc_cpb,enc_inplace_cpb,check\n\r");
+
+  for (i = 0; i < NR_CIPHERS; i++)
+  {
+    cipher = CIPHERS[i];
+    cipher->init(&cipherContext, KEY, cipher->keyLen);
+    nrBlocks = BENCH_WORDS / cipher->blockWords;
+    enc = encInPlace = dec = decInPlace = bytes = bytesInPlace = 0;
+
+    for (run = 0; run < BENCH_RUNS; run++)
+    {
+      tick = KIN1_GetCycleCounter();
+      cipher->encrypt(&cipherContext, TEXT_LIST, cipherText, nrBlocks);
+      enc += KIN1_GetCycleCounter() - tick;
+
+      tick = KIN1_GetCycleCounter();
+      cipher->decrypt(&cipherContext, cipherText, decryptedText, nrBlocks);
+      dec += KIN1_GetCycleCounter() - tick;
+
+      tick = KIN1_GetCycleCounter();
+      cipher->encrypt(&cipherContext, decryptedText, decryptedText, nrBlocks);
+      encInPlace += KIN1_GetCycleCounter() - tick;
+
+      tick = KIN1_GetCycleCounter();
+      cipher->decrypt(&cipherContext, decryptedText, decryptedText, nrBlocks);
+      decInPlace += KIN1_GetCycleCounter() - tick;
+
+      tick = KIN1_GetCycleCounter();
+      CIPHER_encrypt_bytes(cipher, &cipherContext, (const uint8_t*)TEXT_LIST, (uint8_t*)cipherText, nrBlocks);
+      bytes += KIN1_GetCycleCounter() - tick;
+
+      tick = KIN1_GetCycleCounter();
+      CIPHER_encrypt_bytes(cipher, &cipherContext, buffer, buffer, nrBlocks);
+      bytesInPlace += KIN1_GetCycleCounter() - tick;
+
+      CIPHER_decrypt_bytes(cipher, &cipherContext, buffer, buffer, nrBlocks);
+    }
+
+    BENCH_printf("%s,%u,%u,%u,%lu,%lu,%lu,%lu,%lu,%lu,%s,%s,%s\n\r",
+                 cipher->name, cipher->keyLen, 4 * cipher->blockWords, 4 * BENCH_WORDS,
+                 enc / BENCH_RUNS, encInPlace / BENCH_RUNS, dec / BENCH_RUNS, decInPlace / BENCH_RUNS,
+                 bytes / BENCH_RUNS, bytesInPlace / BENCH_RUNS,
+                 cyclesPerByte(encCpb, enc / BENCH_RUNS, 4 * BENCH_WORDS),
+                 cyclesPerByte(encInPlaceCpb, encInPlace / BENCH_RUNS, 4 * BENCH_WORDS),
+                 inPlaceCheck(cipher) ? "FAIL" : "ok");
+  }
+}
+
+/**
+  * @brief  Memory holding an address, from the STM32L476 memory map
+  * @retval "flash", "sram1", "sram2" or "other"
+  */
+static const char* memoryName(uint32_t address)
+{
+  if (address >= FLASH_BASE && address <= FLASH_END)
+  {
+    return "flash";
+  }
+  if (address >= SRAM1_BASE && address < SRAM1_BASE + SRAM1_SIZE_MAX)
+  {
+    return "sram1";
+  }
+  if (address >= SRAM2_BASE && address < SRAM2_BASE + SRAM2_SIZE)
+  {
+    return "sram2";
+  }
+  return "other";
+}
+
+/**
+  * @brief  ECB over the BENCH_WORDS words of TEXT_LIST for every registered
+  *         cipher, with the PLACEMENT of the build and the memory the
+  *         encryption function of the entry actually runs from (the linker
+  *         keeps what is not marked HOT_CODE in flash). One line per cipher
+  *         and placement is obtained by running the three images of
+  *         make placements.
+  * @retval None
+  */
+static void BENCH_placement(void)
+{
+  static const char* const placements[] = { "flash", "sram1", "sram2" };
+  const BlockCipher* cipher;
+  uint32_t nrBlocks;
+  uint32_t tick, enc, dec;
+  uint32_t i, run;
+  char encCpb[16], decCpb[16];
+
+  BENCH_printf("cipher,key_bits,placement,code_memory,bytes,enc_cycles,dec_cycles,enc_cpb,dec_cpb,check\n\r");
+
+  for (i = 0; i < NR_CIPHERS; i++)
+  {
+    cipher = CIPHERS[i];
+    cipher->init(&cipherContext, KEY, cipher->keyLen);
+    nrBlocks = BENCH_WORDS / cipher->blockWords;
+    enc = dec = 0;
+
+    for (run = 0; run < BENCH_RUNS; run++)
+    {
+      tick = KIN1_GetCycleCounter();
+      cipher->encrypt(&cipherContext, TEXT_LIST, cipherText, nrBlocks);
+      enc += KIN1_GetCycleCounter() - tick;
+
+      tick = KIN1_GetCycleCounter();
+      cipher->decrypt(&cipherContext, cipherText, decryptedText, nrBlocks);
+      dec += KIN1_GetCycleCounter() - tick;
+    }
+
+    BENCH_printf("%s,%u,%s,%s,%u,%lu,%lu,%s,%s,%s\n\r",
+                 cipher->name, cipher->keyLen, placements[PLACEMENT], memoryName((uint32_t)cipher->encrypt),
+                 4 * BENCH_WORDS, enc / BENCH_RUNS, dec / BENCH_RUNS,
+                 cyclesPerByte(encCpb, enc / BENCH_RUNS, 4 * BENCH_WORDS),
+                 cyclesPerByte(decCpb, dec / BENCH_RUNS, 4 * BENCH_WORDS),
+                 memcmp(decryptedText, TEXT_LIST, sizeof(decryptedText)) ? "FAIL" : "ok");
+  }
+}
+
+/**
+  * @brief  Invalidate the flash (ART accelerator) instruction and data caches
+  *         through FLASH->ACR, so the next access to the cipher code and its
+  *         flash tables misses as after unrelated code has run. The caches
+  *         can only be reset while disabled; their enable state is kept.
+  * @retval None
+  */
+static void flushFlashCaches(void)
+{
+  uint32_t enabled = FLASH->ACR & (FLASH_ACR_ICEN | FLASH_ACR_DCEN);
+
+  __HAL_FLASH_INSTRUCTION_CACHE_DISABLE();
+  __HAL_FLASH_DATA_CACHE_DISABLE();
+  __HAL_FLASH_INSTRUCTION_CACHE_RESET();
+  __HAL_FLASH_DATA_CACHE_RESET();
+  SET_BIT(FLASH->ACR, enabled);
+}
+
+/**
+  * @brief  First call latency against steady state for every registered
+  *         cipher. cold: the flash caches are flushed before the timed call;
+  *         warm: the same call repeated right after. Both for one block and
+  *         for the BENCH_WORDS words of TEXT_LIST, averaged over BENCH_RUNS.
+  * @retval None
+  */
+static void BENCH_cache(void)
+{
+  const BlockCipher* cipher;
+  uint32_t nrBlocks;
+  uint32_t tick, coldBlock, warmBlock, coldBulk, warmBulk;
+  uint32_t i, run;
+  char coldCpb[16], warmCpb[16];
+
+  BENCH_printf("cipher,key_bits,block_bytes,cold_block_cycles,warm_block_cycles,bytes,cold_cycles,warm_cycles,cold_cpb,warm_cpb,check\n\r");
+
+  for (i = 0; i < NR_CIPHERS; i++)
+  {
+    cipher = CIPHERS[i];
+    cipher->init(&cipherContext, KEY, cipher->keyLen);
+    nrBlocks = BENCH_WORDS / cipher->blockWords;
+    coldBlock = warmBlock = coldBulk = warmBulk = 0;
+
+    for (run = 0; run < BENCH_RUNS; run++)
+    {
+      flushFlashCaches();
+      tick = KIN1_GetCycleCounter();
+      cipher->encrypt(&cipherContext, TEXT_LIST, cipherText, 1);
+      coldBlock += KIN1_GetCycleCounter() - tick;
+
+      tick = KIN1_GetCycleCounter();
+      cipher->encrypt(&cipherContext, TEXT_LIST, cipherText, 1);
+      warmBlock += KIN1_GetCycleCounter() - tick;
+
+      flushFlashCaches();
+      tick = KIN1_GetCycleCounter();
+      cipher->encrypt(&cipherContext, TEXT_LIST, cipherText, nrBlocks);
+      coldBulk += KIN1_GetCycleCounter() - tick;
+
+      tick = KIN1_GetCycleCounter();
+      cipher->encrypt(&cipherContext, TEXT_LIST, cipherText, nrBlocks);
+      warmBulk += KIN1_GetCycleCounter() - tick;
+    }
+
+    cipher->decrypt(&cipherContext, cipherText, decryptedText, nrBlocks);
+
+    BENCH_printf("%s,%u,%u,%lu,%lu,%u,%lu,%lu,%s,%s,%s\n\r",
+                 cipher->name, cipher->keyLen, 4 * cipher->blockWords,
+                 coldBlock / BENCH_RUNS, warmBlock / BENCH_RUNS,
+                 4 * BENCH_WORDS, coldBulk / BENCH_RUNS, warmBulk / BENCH_RUNS,
+                 cyclesPerByte(coldCpb, coldBulk / BENCH_RUNS, 4 * BENCH_WORDS),
+                 cyclesPerByte(warmCpb, warmBulk / BENCH_RUNS, 4 * BENCH_WORDS),
+                 memcmp(decryptedText, TEXT_LIST, sizeof(decryptedText)) ? "FAIL" : "ok");
+  }
+}
+
+/**
+  * @brief  Switch SYSCLK to a point of the clock sweep and reconfigure the
+  *         UART for the new PCLK. SYSCLK goes through HSI16 so MSI and the
+  *         PLL are never changed while they drive it. SystemCoreClock and
+  *         the SysTick are updated by HAL_RCC_ClockConfig.
+  * @retval None
+  */
+static void setClock(const ClockPoint* point)
+{
+  RCC_OscInitTypeDef RCC_OscInitStruct = {0};
+  RCC_ClkInitTypeDef RCC_ClkInitStruct = {0};
+
+  RCC_ClkInitStruct.ClockType = (RCC_CLOCKTYPE_SYSCLK | RCC_CLOCKTYPE_HCLK | RCC_CLOCKTYPE_PCLK1 | RCC_CLOCKTYPE_PCLK2);
+  RCC_ClkInitStruct.AHBCLKDivider = RCC_SYSCLK_DIV1;
+  RCC_ClkInitStruct.APB1CLKDivider = RCC_HCLK_DIV1;
+  RCC_ClkInitStruct.APB2CLKDivider = RCC_HCLK_DIV1;
+
+  RCC_OscInitStruct.OscillatorType = RCC_OSCILLATORTYPE_HSI;
+  RCC_OscInitStruct.HSIState = RCC_HSI_ON;
+  RCC_OscInitStruct.HSICalibrationValue = RCC_HSICALIBRATION_DEFAULT;
+  RCC_OscInitStruct.PLL.PLLState = RCC_PLL_NONE;
+  if(HAL_RCC_OscConfig(&RCC_OscInitStruct) != HAL_OK)
+  {
+    /* Initialization Error */
+    while(1);
+  }
+
+  RCC_ClkInitStruct.SYSCLKSource = RCC_SYSCLKSOURCE_HSI;
+  if(HAL_RCC_ClockConfig(&RCC_ClkInitStruct, FLASH_LATENCY_4) != HAL_OK)
+  {
+    /* Initialization Error */
+    while(1);
+  }
+
+  RCC_OscInitStruct.OscillatorType = RCC_OSCILLATORTYPE_MSI;
+  RCC_OscInitStruct.MSIState = RCC_MSI_ON;
+  RCC_OscInitStruct.MSIClockRange = point->msiRange;
+  RCC_OscInitStruct.MSICalibrationValue = RCC_MSICALIBRATION_DEFAULT;
+  if (point->pll)
+  {
+    RCC_OscInitStruct.PLL.PLLState = RCC_PLL_ON;
+    RCC_OscInitStruct.PLL.PLLSource = RCC_PLLSOURCE_MSI;
+    RCC_OscInitStruct.PLL.PLLM = 1;
+    RCC_OscInitStruct.PLL.PLLN = point->pllN;
+    RCC_OscInitStruct.PLL.PLLR = 2;
+    RCC_OscInitStruct.PLL.PLLP = 7;
+    RCC_OscInitStruct.PLL.PLLQ = 4;
+  }
+  else
+  {
+    RCC_OscInitStruct.PLL.PLLState = RCC_PLL_OFF;
+  }
+  if(HAL_RCC_OscConfig(&RCC_OscInitStruct) != HAL_OK)
+  {
+    /* Initialization Error */
+    while(1);
+  }
+
+  RCC_ClkInitStruct.SYSCLKSource = point->pll ? RCC_SYSCLKSOURCE_PLLCLK : RCC_SYSCLKSOURCE_MSI;
+  if(HAL_RCC_ClockConfig(&RCC_ClkInitStruct, point->latency) != HAL_OK)
+  {
+    /* Initialization Error */
+    while(1);
+  }
+
+  /* new baud rate divider; RXNE and error interrupts are left enabled */
+  if(HAL_UART_Init(&UartHandle) != HAL_OK)
+  {
+    /* Initialization Error */
+    while(1);
+  }
+}
+
+/**
+  * @brief  ECB over the BENCH_WORDS words of TEXT_LIST for every registered
+  *         cipher at every point of clockPoints: cycles per byte, which
+  *         grow with the flash wait states, and bytes per second of wall
+  *         clock time. Ends at 80 MHz as configured by SystemClock_Config.
+  * @retval None
+  */
+static void BENCH_clock(void)
+{
+  const BlockCipher* cipher;
+  uint32_t nrBlocks;
+  uint32_t tick, enc, dec;
+  uint32_t i, j, run;
+  char encCpb[16], decCpb[16];
+
+  for (j = 0; j < sizeof(clockPoints) / sizeof(clockPoints[0]); j++)
+  {
+    setClock(&clockPoints[j]);
+    HAL_Delay(10);
+
+    BENCH_printf("sysclk_hz,source,latency,cipher,key_bits,bytes,enc_cycles,dec_cycles,enc_cpb,dec_cpb,enc_bytes_per_s,dec_bytes_per_s,check\n\r");
+
+    for (i = 0; i < NR_CIPHERS; i++)
+    {
+      cipher = CIPHERS[i];
+      cipher->init(&cipherContext, KEY, cipher->keyLen);
+      nrBlocks = BENCH_WORDS / cipher->blockWords;
+      enc = dec = 0;
+
+      for (run = 0; run < BENCH_RUNS; run++)
+      {
+        tick = KIN1_GetCycleCounter();
+        cipher->encrypt(&cipherContext, TEXT_LIST, cipherText, nrBlocks);
+        enc += KIN1_GetCycleCounter() - tick;
+
+        tick = KIN1_GetCycleCounter();
+        cipher->decrypt(&cipherContext, cipherText, decryptedText, nrBlocks);
+        dec += KIN1_GetCycleCounter() - tick;
+      }
+
+      BENCH_printf("%lu,%s,%lu,%s,%u,%u,%lu,%lu,%s,%s,%lu,%lu,%s\n\r",
+                   SystemCoreClock, clockPoints[j].source, clockPoints[j].latency,
+                   cipher->name, cipher->keyLen, 4 * BENCH_WORDS, enc / BENCH_RUNS, dec / BENCH_RUNS,
+                   cyclesPerByte(encCpb, enc / BENCH_RUNS, 4 * BENCH_WORDS),
+                   cyclesPerByte(decCpb, dec / BENCH_RUNS, 4 * BENCH_WORDS),
+                   (uint32_t)((uint64_t)4 * BENCH_WORDS * SystemCoreClock / (enc / BENCH_RUNS)),
+                   (uint32_t)((uint64_t)4 * BENCH_WORDS * SystemCoreClock / (dec / BENCH_RUNS)),
+                   memcmp(decryptedText, TEXT_LIST, sizeof(decryptedText)) ? "FAIL" : "ok");
+    }
+  }
+}
+
+#if BENCHMARK == BENCH_UART_DMA
+/**
+  * @brief  Reception DMA callbacks: one half of dmaRxBuffer is full
+  * @param  huart: UART handle pointer
+  * @retval None
+  */
+void HAL_UART_RxHalfCpltCallback(UART_HandleTypeDef* huart)
+{
+  rxTick[0] = KIN1_GetCycleCounter();
+  rxChunks++;
+}
+
+void HAL_UART_RxCpltCallback(UART_HandleTypeDef* huart)
+{
+  rxTick[1] = KIN1_GetCycleCounter();
+  rxChunks++;
+}
+
+/**
+  * @brief  Transmission DMA callback: the last byte of the chunk is sent
+  * @param  huart: UART handle pointer
+  * @retval None
+  */
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef* huart)
+{
+  txBusy = 0;
+}
+#endif
+
+/**
+  * @brief  Reconfigure the UART for another baud rate (DMA links are kept)
+  * @retval None
+  */
+static void setBaudRate(uint32_t baudRate)
+{
+  UartHandle.Init.BaudRate = baudRate;
+  if(HAL_UART_Init(&UartHandle) != HAL_OK)
+  {
+    /* Initialization Error */
+    while(1);
+  }
+}
+
+/**
+  * @brief  Encrypt-and-echo pipeline over the UART with the first registry
+  *         entry of the selected cipher, at every baud rate of the list.
+  *         The reception runs on circular DMA; every half of dmaRxBuffer is
+  *         encrypted (ECB, byte API) in this loop and sent back by DMA while
+  *         the next one arrives. A prompt line "uart_dma,<baud>,<bytes>" is
+  *         printed at 115200 baud before switching, the results after
+  *         switching back (Scripts/uart_dma_stream.py drives the host side).
+  *         latency: from the chunk fully received to its ciphertext handed
+  *         to the transmission DMA; overruns: chunks the DMA had started to
+  *         overwrite when they were taken.
+  * @retval None
+  */
+static void BENCH_uartDma(void)
+{
+  static const uint32_t baudRates[] = { 115200, 460800, 921600 };
+  const BlockCipher* cipher = CIPHERS[0];
+  uint32_t nrBlocks = UART_DMA_CHUNK / (4 * cipher->blockWords);
+  uint32_t tick, start, end, crypt, latency, maxLatency, overruns, lastRx;
+  uint32_t chunk, half, i;
+
+  cipher->init(&cipherContext, KEY, cipher->keyLen);
+
+  /* reception through the DMA, not the RXNE interrupt set up by main */
+  LL_USART_DisableIT_RXNE(USARTx);
+
+  for (i = 0; i < sizeof(baudRates) / sizeof(baudRates[0]); i++)
+  {
+    BENCH_printf("uart_dma,%lu,%u\n\r", baudRates[i], UART_DMA_BYTES);
+    setBaudRate(baudRates[i]);
+
+    rxChunks = 0;
+    txBusy = 0;
+    start = end = crypt = latency = maxLatency = overruns = 0;
+    if(HAL_UART_Receive_DMA(&UartHandle, dmaRxBuffer, sizeof(dmaRxBuffer)) != HAL_OK)
+    {
+      /* Initialization Error */
+      while(1);
+    }
+
+    lastRx = HAL_GetTick();
+    for (chunk = 0; chunk < UART_DMA_BYTES / UART_DMA_CHUNK; chunk++)
+    {
+      /* wait for the next half, the host has UART_DMA_TIMEOUT to start and
+         stopped sending after a 100 ms gap */
+      while (rxChunks == chunk && HAL_GetTick() - lastRx < (chunk == 0 ? UART_DMA_TIMEOUT : 100))
+      {
+      }
+      if (rxChunks == chunk)
+      {
+        break;
+      }
+      lastRx = HAL_GetTick();
+
+      half = chunk % 2;
+      if (chunk == 0)
+      {
+        start = rxTick[0];
+      }
+      if (rxChunks - chunk > 1)
+      {
+        overruns++;
+      }
+
+      tick = KIN1_GetCycleCounter();
+      CIPHER_encrypt_bytes(cipher, &cipherContext, dmaRxBuffer + half * UART_DMA_CHUNK, dmaTxBuffer[half], nrBlocks);
+      crypt += KIN1_GetCycleCounter() - tick;
+
+      /* previous chunk, sent from the other buffer */
+      while (txBusy)
+      {
+      }
+      txBusy = 1;
+      HAL_UART_Transmit_DMA(&UartHandle, dmaTxBuffer[half], UART_DMA_CHUNK);
+
+      tick = KIN1_GetCycleCounter() - rxTick[half];
+      latency += tick;
+      if (tick > maxLatency)
+      {
+        maxLatency = tick;
+      }
+    }
+
+    while (txBusy)
+    {
+    }
+    end = KIN1_GetCycleCounter();
+    HAL_UART_DMAStop(&UartHandle);
+
+    /* leave the host time to switch back */
+    HAL_Delay(500);
+    setBaudRate(115200);
+
+    BENCH_printf("cipher,baud,bytes,chunk_bytes,bytes_per_s,enc_cycles_per_chunk,latency_cycles,max_latency_cycles,latency_us,overruns\n\r");
+    if (chunk == 0)
+    {
+      BENCH_printf("%s,%lu,0,%u,0,0,0,0,0,0\n\r", cipher->name, baudRates[i], UART_DMA_CHUNK);
+      continue;
+    }
+    BENCH_printf("%s,%lu,%lu,%u,%lu,%lu,%lu,%lu,%lu,%lu\n\r",
+                 cipher->name, baudRates[i], chunk * UART_DMA_CHUNK, UART_DMA_CHUNK,
+                 (uint32_t)((uint64_t)chunk * UART_DMA_CHUNK * SystemCoreClock / (end - start)),
+                 crypt / chunk, latency / chunk, maxLatency,
+                 latency / chunk / (SystemCoreClock / 1000000), overruns);
+  }
+}
+
+/**
+  * @brief  Start the benchmark timer: free running at the core clock, a
+  *         compare interrupt every period cycles at the highest priority
+  * @retval None
+  */
+static void startTimer(uint32_t period)
+{
+  timerPeriod = period;
+
+  BENCH_TIMx_CLK_ENABLE();
+  LL_TIM_SetPrescaler(BENCH_TIMx, 0);
+  LL_TIM_SetAutoReload(BENCH_TIMx, 0xFFFFFFFF);
+  LL_TIM_GenerateEvent_UPDATE(BENCH_TIMx);
+  LL_TIM_SetCounter(BENCH_TIMx, 0);
+  LL_TIM_OC_SetCompareCH1(BENCH_TIMx, period);
+  LL_TIM_ClearFlag_CC1(BENCH_TIMx);
+  LL_TIM_EnableIT_CC1(BENCH_TIMx);
+
+  HAL_NVIC_SetPriority(BENCH_TIMx_IRQn, 0, 0);
+  HAL_NVIC_EnableIRQ(BENCH_TIMx_IRQn);
+  LL_TIM_EnableCounter(BENCH_TIMx);
+}
+
+/**
+  * @brief  Stop the benchmark timer (may be called from its interrupt)
+  * @retval None
+  */
+static void stopTimer(void)
+{
+  LL_TIM_DisableIT_CC1(BENCH_TIMx);
+  LL_TIM_DisableCounter(BENCH_TIMx);
+  HAL_NVIC_DisableIRQ(BENCH_TIMx_IRQn);
+  LL_TIM_ClearFlag_CC1(BENCH_TIMx);
+}
+
+/**
+  * @brief  Benchmark timer compare interrupt: schedules the next compare one
+  *         period after this one (one period after now when late) and runs
+  *         the hook
+  * @param  counter: timer counter on entry of the interrupt handler
+  * @retval None
+  */
+void BENCH_Timer_Callback(uint32_t counter)
+{
+  uint32_t compare = LL_TIM_OC_GetCompareCH1(BENCH_TIMx);
+  uint32_t latency = counter - compare;
+  uint32_t next = compare + timerPeriod;
+
+  timerEvents++;
+  timerLatencySum += latency;
+  if (latency > timerLatencyMax)
+  {
+    timerLatencyMax = latency;
+  }
+
+  if ((int32_t)(next - counter) <= 0)
+  {
+    next = counter + timerPeriod;
+  }
+  LL_TIM_OC_SetCompareCH1(BENCH_TIMx, next);
+
+  if (timerHook)
+  {
+    timerHook();
+  }
+}
+
+/**
+  * @brief  Job completion callback (PendSV): queueing and processing times
+  * @param  job: the completed job
+  * @retval None
+  */
+static void jobDone(CryptoJob* job)
+{
+  uint32_t queued = job->started - job->submitted;
+
+  jobsQueueCycles += queued;
+  if (queued > jobsMaxQueueCycles)
+  {
+    jobsMaxQueueCycles = queued;
+  }
+  jobsProcessCycles += job->finished - job->started;
+  jobsLastFinished = job->finished;
+  jobsCompleted++;
+}
+
+/**
+  * @brief  Load generator (timer interrupt): submits one job per period to
+  *         the queue run by PendSV, for BENCH_JOB_WINDOW_MS
+  * @retval None
+  */
+static void jobProducer(void)
+{
+  if (KIN1_GetCycleCounter() - loadStart >= SystemCoreClock / 1000 * BENCH_JOB_WINDOW_MS)
+  {
+    stopTimer();
+    jobsLoading = 0;
+    return;
+  }
+
+  if (JOBQ_submit(&cryptoJobs, &jobPool[jobsSubmitted % JOB_POOL]) == 0)
+  {
+    jobsSubmitted++;
+  }
+  else
+  {
+    jobsRejected++;
+  }
+}
+
+/**
+  * @brief  Crypto job queue under load for every registered cipher: the
+  *         benchmark timer interrupt submits an ECB encryption job of
+  *         BENCH_JOB_BLOCKS blocks at each offered rate, PendSV runs them.
+  *         queue: cycles from submission to the start of the processing;
+  *         process: cycles of the processing; rejected: submissions to a
+  *         full queue. The ciphertext of the jobs is checked against a
+  *         direct encryption.
+  * @retval None
+  */
+static void BENCH_jobs(void)
+{
+  static const uint32_t rates[] = { 1000, 4000, 16000, 64000 };
+  char cpb[16];
+  uint32_t i, r, n;
+
+  BENCH_printf("cipher,offered_jobs_per_s,job_bytes,submitted,rejected,completed,jobs_per_s,queue_cycles,max_queue_cycles,process_cycles,queue_us,process_cpb,check\n\r");
+
+  for (i = 0; i < NR_CIPHERS; i++)
+  {
+    const BlockCipher* cipher = CIPHERS[i];
+    uint32_t jobBytes = 4 * JOB_WORDS(cipher);
+
+    cipher->init(&cipherContext, KEY, cipher->keyLen);
+    cipher->encrypt(&cipherContext, TEXT_LIST, decryptedText, BENCH_JOB_BLOCKS * JOB_POOL);
+
+    for (n = 0; n < JOB_POOL; n++)
+    {
+      jobPool[n].cipher = cipher;
+      jobPool[n].key = &cipherContext;
+      jobPool[n].direction = JOB_ENCRYPT;
+      jobPool[n].in = TEXT_LIST + n * JOB_WORDS(cipher);
+      jobPool[n].out = cipherText + n * JOB_WORDS(cipher);
+      jobPool[n].nrBlocks = BENCH_JOB_BLOCKS;
+      jobPool[n].callback = jobDone;
+    }
+
+    for (r = 0; r < sizeof(rates) / sizeof(rates[0]); r++)
+    {
+      memset(cipherText, 0, sizeof(cipherText));
+      jobsSubmitted = jobsRejected = jobsCompleted = 0;
+      jobsQueueCycles = jobsMaxQueueCycles = jobsProcessCycles = 0;
+      jobsLoading = 1;
+      timerHook = jobProducer;
+
+      loadStart = KIN1_GetCycleCounter();
+      jobsLastFinished = loadStart;
+      startTimer(SystemCoreClock / rates[r]);
+
+      /* the producer stops itself, then the queue drains */
+      while (jobsLoading || JOBQ_pending(&cryptoJobs) != 0)
+      {
+      }
+      timerHook = NULL;
+
+      n = jobsCompleted < JOB_POOL ? jobsCompleted : JOB_POOL;
+      if (jobsCompleted == 0)
+      {
+        BENCH_printf("%s,%lu,%lu,0,%lu,0,0,0,0,0,0,0,FAIL\n\r", cipher->name, rates[r], jobBytes, jobsRejected);
+        continue;
+      }
+      BENCH_printf("%s,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%s,%s\n\r",
+                   cipher->name, rates[r], jobBytes, jobsSubmitted, jobsRejected, jobsCompleted,
+                   (uint32_t)((uint64_t)jobsCompleted * SystemCoreClock / (jobsLastFinished - loadStart)),
+                   jobsQueueCycles / jobsCompleted, jobsMaxQueueCycles, jobsProcessCycles / jobsCompleted,
+                   jobsQueueCycles / jobsCompleted / (SystemCoreClock / 1000000),
+                   cyclesPerByte(cpb, jobsProcessCycles / jobsCompleted, jobBytes),
+                   memcmp(cipherText, decryptedText, n * jobBytes) ? "FAIL" : "ok");
+    }
+  }
+}
+
+/**
+  * @brief  One in place pass over chunkBuffer with the benchmark timer
+  *         running: ECB encryption (ctr NULL) or CTR. chunk 0: a single call
+  *         with the interrupts enabled; otherwise steps of at most chunk
+  *         blocks (CHUNKED_step), each with the interrupts masked
+  * @retval Cycles of the pass
+  */
+static uint32_t chunkedPass(const BlockCipher* cipher, CtrContext* ctr, uint32_t chunk)
+{
+  uint32_t nrBlocks = BENCH_CHUNK_BYTES / (4 * cipher->blockWords);
+  uint32_t tick, left;
+
+  timerEvents = timerLatencySum = timerLatencyMax = 0;
+  startTimer(BENCH_CHUNK_PERIOD);
+
+  tick = KIN1_GetCycleCounter();
+  if (chunk == 0)
+  {
+    if (ctr)
+    {
+      CTR_crypt(ctr, chunkBuffer, chunkBuffer, BENCH_CHUNK_BYTES / 4);
+    }
+    else
+    {
+      cipher->encrypt(&cipherContext, chunkBuffer, chunkBuffer, nrBlocks);
+    }
+  }
+  else
+  {
+    CHUNKED_init(&chunkedContext, cipher, &cipherContext, ctr, CHUNKED_ENCRYPT, chunkBuffer, chunkBuffer, nrBlocks);
+    do
+    {
+      __disable_irq();
+      left = CHUNKED_step(&chunkedContext, chunk);
+      __enable_irq();
+      /* yield point of a cooperative task */
+    } while (left != 0);
+  }
+  tick = KIN1_GetCycleCounter() - tick;
+
+  stopTimer();
+  return tick;
+}
+
+/**
+  * @brief  Worst case interrupt latency against the chunk size of the
+  *         resumable API (chunked.h) for every registered cipher: ECB and
+  *         CTR encryption of BENCH_CHUNK_BYTES in place while the benchmark
+  *         timer interrupts every BENCH_CHUNK_PERIOD cycles. Every step runs
+  *         with the interrupts masked (critical section or same priority
+  *         task), the first row of each mode is one call with the
+  *         interrupts enabled and the reference of the overhead, the last
+  *         one a single step over the whole buffer. The buffer is restored
+  *         and checked against the start of the flash after every pass.
+  * @retval None
+  */
+static void BENCH_latency(void)
+{
+  static const uint32_t chunks[] = { 0, 1, 4, 16, 64, 256, 0xFFFFFFFF };
+  static const char* const modes[] = { "ecb", "ctr" };
+  char cpb[16];
+  uint32_t i, m, c, cycles, reference, overhead, nrBlocks;
+  CtrContext* ctr;
+  int check;
+
+  BENCH_printf("cipher,mode,bytes,chunk_blocks,cycles,cycles_per_byte,overhead_pct,interrupts,latency_cycles,max_latency_cycles,max_latency_us,check\n\r");
+
+  for (i = 0; i < NR_CIPHERS; i++)
+  {
+    const BlockCipher* cipher = CIPHERS[i];
+    nrBlocks = BENCH_CHUNK_BYTES / (4 * cipher->blockWords);
+
+    cipher->init(&cipherContext, KEY, cipher->keyLen);
+
+    for (m = 0; m < 2; m++)
+    {
+      ctr = m ? &ctrContext : NULL;
+      reference = 0;
+
+      for (c = 0; c < sizeof(chunks) / sizeof(chunks[0]); c++)
+      {
+        memcpy(chunkBuffer, (const void*)FLASH_BASE, BENCH_CHUNK_BYTES);
+        if (ctr)
+        {
+          CTR_init(ctr, cipher, &cipherContext, NONCE_LIST);
+        }
+
+        cycles = chunkedPass(cipher, ctr, chunks[c]);
+        if (chunks[c] == 0)
+        {
+          reference = cycles;
+        }
+
+        /* undo the pass */
+        if (ctr)
+        {
+          CTR_init(ctr, cipher, &cipherContext, NONCE_LIST);
+          CTR_crypt(ctr, chunkBuffer, chunkBuffer, BENCH_CHUNK_BYTES / 4);
+        }
+        else
+        {
+          cipher->decrypt(&cipherContext, chunkBuffer, chunkBuffer, nrBlocks);
+        }
+        check = memcmp(chunkBuffer, (const void*)FLASH_BASE, BENCH_CHUNK_BYTES);
+
+        /* overhead in hundredths of a percent, 0 when faster */
+        overhead = cycles > reference ? (uint32_t)((uint64_t)(cycles - reference) * 10000 / reference) : 0;
+
+        BENCH_printf("%s,%s,%u,%lu,%lu,%s,%lu.%02lu,%lu,%lu,%lu,%lu,%s\n\r",
+                     cipher->name, modes[m], BENCH_CHUNK_BYTES,
+                     chunks[c] < nrBlocks ? chunks[c] : nrBlocks, cycles,
+                     cyclesPerByte(cpb, cycles, BENCH_CHUNK_BYTES),
+                     overhead / 100, overhead % 100, timerEvents,
+                     timerEvents ? timerLatencySum / timerEvents : 0, timerLatencyMax,
+                     timerLatencyMax / (SystemCoreClock / 1000000),
+                     check ? "FAIL" : "ok");
+      }
+    }
+  }
+}
+
+#ifdef USE_CMSIS_RTOS2
+/**
+  * @brief  Client thread of the crypto service: BENCH_RTOS_REQUESTS
+  *         encryptions, the interactive ones 1 ms apart, the bulk ones back
+  *         to back
+  * @param  argument: its ServiceClient
+  * @retval None
+  */
+static void serviceClientThread(void* argument)
+{
+  ServiceClient* client = argument;
+  uint32_t i, tick;
+
+  for (i = 0; i < BENCH_RTOS_REQUESTS; i++)
+  {
+    if (client->priority == SERVICE_INTERACTIVE)
+    {
+      osDelay(1);
+    }
+    tick = KIN1_GetCycleCounter();
+    SERVICE_crypt(client->session, SERVICE_ENCRYPT, client->priority, client->in, client->out, client->nrBlocks);
+    client->latency[i] = KIN1_GetCycleCounter() - tick;
+  }
+
+  osThreadFlagsSet(clientsOwner, CLIENT_FLAG(client - serviceClients));
+  osThreadExit();
+}
+
+/**
+  * @brief  Average, 99th percentile and maximum of the request latencies of
+  *         one priority class over the first nrClients clients
+  * @retval Number of requests of the class
+  */
+static uint32_t latencyStats(uint32_t nrClients, uint8_t priority, uint32_t* avg, uint32_t* p99, uint32_t* max)
+{
+  uint32_t n = 0, sum = 0, c, i, j, v;
+
+  for (c = 0; c < nrClients; c++)
+  {
+    if (serviceClients[c].priority != priority)
+    {
+      continue;
+    }
+    for (i = 0; i < BENCH_RTOS_REQUESTS; i++)
+    {
+      /* insertion sort */
+      v = serviceClients[c].latency[i];
+      for (j = n; j > 0 && latencySamples[j - 1] > v; j--)
+      {
+        latencySamples[j] = latencySamples[j - 1];
+      }
+      latencySamples[j] = v;
+      sum += v;
+      n++;
+    }
+  }
+
+  *avg = n ? sum / n : 0;
+  *p99 = n ? latencySamples[n * 99 / 100] : 0;
+  *max = n ? latencySamples[n - 1] : 0;
+  return n;
+}
+
+/**
+  * @brief  Crypto service (service.h) with 1 to BENCH_RTOS_CLIENTS client
+  *         threads, each with its session of the first registry entry of
+  *         the selected cipher: all clients bulk (BENCH_RTOS_BLOCKS blocks
+  *         per request), then client 0 interactive (one block every 1 ms,
+  *         at a priority above the service thread). Throughput of all the
+  *         clients, and latency per request of each class (average, 99th
+  *         percentile, maximum). The bulk ciphertexts are checked against a
+  *         direct encryption.
+  * @retval None
+  */
+static void BENCH_rtos(void)
+{
+  static const char* const mixes[] = { "bulk", "mixed" };
+  const BlockCipher* cipher = CIPHERS[0];
+  uint32_t words = BENCH_RTOS_BLOCKS * cipher->blockWords;
+  uint32_t nrClients, mix, c, start, cycles, bytes, check;
+  uint32_t bulkAvg, bulkP99, bulkMax, intAvg, intP99, intMax;
+  osThreadAttr_t attr;
+
+  clientsOwner = osThreadGetId();
+  cipher->init(&cipherContext, KEY, cipher->keyLen);
+  cipher->encrypt(&cipherContext, TEXT_LIST, decryptedText, BENCH_RTOS_CLIENTS * BENCH_RTOS_BLOCKS);
+
+  BENCH_printf("cipher,clients,mix,bulk_blocks,bytes,bytes_per_s,bulk_latency_cycles,bulk_p99_cycles,bulk_max_cycles,interactive_latency_cycles,interactive_p99_cycles,interactive_max_cycles,check\n\r");
+
+  for (nrClients = 1; nrClients <= BENCH_RTOS_CLIENTS; nrClients++)
+  {
+    for (mix = 0; mix < 2; mix++)
+    {
+      memset(cipherText, 0, sizeof(cipherText));
+      bytes = 0;
+
+      for (c = 0; c < nrClients; c++)
+      {
+        ServiceClient* client = &serviceClients[c];
+
+        client->priority = (mix == 1 && c == 0) ? SERVICE_INTERACTIVE : SERVICE_BULK;
+        client->nrBlocks = client->priority == SERVICE_BULK ? BENCH_RTOS_BLOCKS : 1;
+        client->in = TEXT_LIST + c * words;
+        client->out = cipherText + c * words;
+        client->session = SERVICE_open(cipher, KEY);
+        bytes += BENCH_RTOS_REQUESTS * client->nrBlocks * 4 * cipher->blockWords;
+      }
+
+      start = KIN1_GetCycleCounter();
+      for (c = 0; c < nrClients; c++)
+      {
+        memset(&attr, 0, sizeof(attr));
+        attr.stack_size = 512;
+        attr.priority = serviceClients[c].priority == SERVICE_INTERACTIVE ? osPriorityHigh : osPriorityNormal;
+        osThreadNew(serviceClientThread, &serviceClients[c], &attr);
+      }
+      osThreadFlagsWait(CLIENT_FLAG(nrClients) - CLIENT_FLAG(0), osFlagsWaitAll, osWaitForever);
+      cycles = KIN1_GetCycleCounter() - start;
+
+      check = 0;
+      for (c = 0; c < nrClients; c++)
+      {
+        if (serviceClients[c].priority == SERVICE_BULK)
+        {
+          check |= memcmp(serviceClients[c].out, decryptedText + c * words, 4 * words);
+        }
+        SERVICE_close(serviceClients[c].session);
+      }
+
+      latencyStats(nrClients, SERVICE_BULK, &bulkAvg, &bulkP99, &bulkMax);
+      latencyStats(nrClients, SERVICE_INTERACTIVE, &intAvg, &intP99, &intMax);
+
+      BENCH_printf("%s,%lu,%s,%u,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%s\n\r",
+                   cipher->name, nrClients, mixes[mix], BENCH_RTOS_BLOCKS, bytes,
+                   (uint32_t)((uint64_t)bytes * SystemCoreClock / cycles),
+                   bulkAvg, bulkP99, bulkMax, intAvg, intP99, intMax,
+                   check ? "FAIL" : "ok");
+    }
+  }
+}
+#endif
+
+/**
+  * @brief  Seed of the random workload: BENCH_SEED when set, a fresh one from
+  *         the RNG otherwise
+  * @retval Seed
+  */
+static uint32_t workloadSeed(void)
+{
+  uint32_t seed = BENCH_SEED;
+
+  while (seed == 0)
+  {
+    if (RngHandle.State == HAL_RNG_STATE_RESET)
+    {
+      RngHandle.Instance = RNG;
+      if(HAL_RNG_Init(&RngHandle) != HAL_OK)
+      {
+        /* Initialization Error */
+        while(1);
+      }
+    }
+    if(HAL_RNG_GenerateRandomNumber(&RngHandle, &seed) != HAL_OK)
+    {
+      /* Seed or clock error */
+      while(1);
+    }
+  }
+  return seed;
+}
+
+/**
+  * @brief  Fill words with the workload generator (SplitMix32 style: the same
+  *         seed always gives the same inputs, so a run can be replayed)
+  * @retval None
+  */
+static void fillRandom(uint32_t* words, uint32_t nrWords)
+{
+  uint32_t z;
+
+  for (; nrWords > 0; nrWords--)
+  {
+    workloadState += 0x9E3779B9;
+    z = workloadState;
+    z = (z ^ (z >> 16)) * 0x85EBCA6B;
+    z = (z ^ (z >> 13)) * 0xC2B2AE35;
+    *words++ = z ^ (z >> 16);
+  }
+}
+
+/**
+  * @brief  Sort cycle samples in place (insertion sort, a few hundred samples)
+  * @retval None
+  */
+static void sortSamples(uint32_t* samples, uint32_t n)
+{
+  uint32_t i, j, v;
+
+  for (i = 1; i < n; i++)
+  {
+    v = samples[i];
+    for (j = i; j > 0 && samples[j - 1] > v; j--)
+    {
+      samples[j] = samples[j - 1];
+    }
+    samples[j] = v;
+  }
+}
+
+/**
+  * @brief  Cycle distributions of the key setup and of one block encryption
+  *         of every registered cipher over BENCH_RANDOM_SAMPLES inputs of
+  *         each class: fixed (KEY, first block of TEXT_LIST, the numbers of
+  *         the other modes), random plaintexts under KEY, random keys and
+  *         plaintexts. Every cipher gets the same inputs from the seed,
+  *         printed so the run can be replayed with BENCH_SEED. Each block
+  *         is decrypted back as a check.
+  * @retval None
+  */
+static void BENCH_random(void)
+{
+  static const char* const classes[] = { "fixed", "random_text", "random_key" };
+  uint32_t seed = workloadSeed();
+  uint32_t key[8], block[MAX_BLOCK_WORDS], out[MAX_BLOCK_WORDS];
+  uint32_t i, c, n, tick, sum;
+  int check;
+
+  BENCH_printf("cipher,inputs,seed,samples,setup_min,setup_median,setup_max,enc_min,enc_median,enc_p99,enc_max,enc_avg,check\n\r");
+
+  for (i = 0; i < NR_CIPHERS; i++)
+  {
+    const BlockCipher* cipher = CIPHERS[i];
+
+    for (c = 0; c < 3; c++)
+    {
+      workloadState = seed;
+      memcpy(key, KEY, sizeof(key));
+      memcpy(block, TEXT_LIST, 4 * cipher->blockWords);
+      check = 0;
+      sum = 0;
+
+      for (n = 0; n < BENCH_RANDOM_SAMPLES; n++)
+      {
+        if (c == 2)
+        {
+          fillRandom(key, 8);
+        }
+        if (c >= 1)
+        {
+          fillRandom(block, cipher->blockWords);
+        }
+
+        tick = KIN1_GetCycleCounter();
+        cipher->init(&cipherContext, key, cipher->keyLen);
+        setupSamples[n] = KIN1_GetCycleCounter() - tick;
+
+        tick = KIN1_GetCycleCounter();
+        cipher->encrypt(&cipherContext, block, out, 1);
+        encryptSamples[n] = KIN1_GetCycleCounter() - tick;
+        sum += encryptSamples[n];
+
+        cipher->decrypt(&cipherContext, out, out, 1);
+        check |= memcmp(out, block, 4 * cipher->blockWords);
+      }
+
+      sortSamples(setupSamples, BENCH_RANDOM_SAMPLES);
+      sortSamples(encryptSamples, BENCH_RANDOM_SAMPLES);
+
+      BENCH_printf("%s,%s,0x%08lx,%u,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%s\n\r",
+                   cipher->name, classes[c], seed, BENCH_RANDOM_SAMPLES,
+                   setupSamples[0], setupSamples[BENCH_RANDOM_SAMPLES / 2], setupSamples[BENCH_RANDOM_SAMPLES - 1],
+                   encryptSamples[0], encryptSamples[BENCH_RANDOM_SAMPLES / 2],
+                   encryptSamples[BENCH_RANDOM_SAMPLES * 99 / 100], encryptSamples[BENCH_RANDOM_SAMPLES - 1],
+                   sum / BENCH_RANDOM_SAMPLES, check ? "FAIL" : "ok");
+    }
+  }
+}
+
+/**
+  * @brief  Key agility of every registered cipher: cycles per rekey and keys
+  *         per second (key setup alone, alternating between two keys), bulk
+  *         encryption cycles per byte over the 3 KB buffer, the break-even
+  *         message length where the key setup costs as much as encrypting
+  *         the message, and the cycles per byte of messages of 16, 64 and
+  *         1024 bytes each under a key of its own (setup + encryption).
+  * @retval None
+  */
+static void BENCH_rekey(void)
+{
+  static const uint32_t messages[] = { 16, 64, 1024 };
+  uint32_t keys[2][8];
+  uint32_t nrBlocks, tick, setup, enc, m, msg[3];
+  uint32_t i, w, run;
+  char encCpb[16], msgCpb[3][16];
+
+  /* the second key is the complement of the first */
+  for (w = 0; w < 8; w++)
+  {
+    keys[0][w] = KEY[w];
+    keys[1][w] = ~KEY[w];
+  }
+
+  BENCH_printf("cipher,key_bits,block_bytes,rekey_cycles,keys_per_s,enc_cpb,break_even_bytes,cpb_rekey_16,cpb_rekey_64,cpb_rekey_1024\n\r");
+
+  for (i = 0; i < NR_CIPHERS; i++)
+  {
+    const BlockCipher* cipher = CIPHERS[i];
+    nrBlocks = BENCH_WORDS / cipher->blockWords;
+    setup = enc = 0;
+
+    for (run = 0; run < BENCH_RUNS; run++)
+    {
+      tick = KIN1_GetCycleCounter();
+      cipher->init(&cipherContext, keys[run % 2], cipher->keyLen);
+      setup += KIN1_GetCycleCounter() - tick;
+    }
+
+    for (run = 0; run < BENCH_RUNS; run++)
+    {
+      tick = KIN1_GetCycleCounter();
+      cipher->encrypt(&cipherContext, TEXT_LIST, cipherText, nrBlocks);
+      enc += KIN1_GetCycleCounter() - tick;
+    }
+
+    /* one key per message */
+    for (m = 0; m < 3; m++)
+    {
+      msg[m] = 0;
+      for (run = 0; run < BENCH_RUNS; run++)
+      {
+        tick = KIN1_GetCycleCounter();
+        cipher->init(&cipherContext, keys[run % 2], cipher->keyLen);
+        cipher->encrypt(&cipherContext, TEXT_LIST, cipherText, messages[m] / (4 * cipher->blockWords));
+        msg[m] += KIN1_GetCycleCounter() - tick;
+      }
+    }
+
+    setup /= BENCH_RUNS;
+    enc /= BENCH_RUNS;
+    BENCH_printf("%s,%u,%u,%lu,%lu,%s,%lu,%s,%s,%s\n\r",
+                 cipher->name, cipher->keyLen, 4 * cipher->blockWords,
+                 setup, SystemCoreClock / (setup ? setup : 1),
+                 cyclesPerByte(encCpb, enc, 4 * BENCH_WORDS),
+                 (uint32_t)((uint64_t)setup * 4 * BENCH_WORDS / enc),
+                 cyclesPerByte(msgCpb[0], msg[0] / BENCH_RUNS, messages[0]),
+                 cyclesPerByte(msgCpb[1], msg[1] / BENCH_RUNS, messages[1]),
+                 cyclesPerByte(msgCpb[2], msg[2] / BENCH_RUNS, messages[2]));
+  }
+}
+
+/**
+  * @brief  Paint the free stack below the caller with STACK_PATTERN, down to
+  *         BENCH_STACK_PAINT bytes or the end of the heap reserve
+  * @retval None
+  */
+static void __attribute__((noinline)) paintStack(void)
+{
+  uint32_t* sp = (uint32_t*)__get_MSP();
+  uint32_t* heapEnd = (uint32_t*)(&_end + (uint32_t)&_Min_Heap_Size);
+  uint32_t* p;
+
+  stackBottom = sp - BENCH_STACK_PAINT / 4;
+  if (stackBottom < heapEnd)
+  {
+    stackBottom = heapEnd;
+  }
+
+  /* the words right below sp are this function's own calls */
+  for (p = stackBottom; p < sp - 8; p++)
+  {
+    *p = STACK_PATTERN;
+  }
+}
+
+/**
+  * @brief  Stack used since paintStack, down from top (the stack pointer of
+  *         the caller when it painted)
+  * @retval Bytes
+  */
+static uint32_t stackUsed(const uint32_t* top)
+{
+  const uint32_t* p = stackBottom;
+
+  while (p < top && *p == STACK_PATTERN)
+  {
+    p++;
+  }
+  return (uint32_t)((const uint8_t*)top - (const uint8_t*)p);
+}
+
+/**
+  * @brief  Memory footprint of every registered cipher: peak stack of the key
+  *         setup, of the ECB encryption and of the decryption over the 3 KB
+  *         buffer (stack painting, interrupt frames stacked meanwhile
+  *         included), bytes of the expanded key in the context, and the
+  *         encryption cycles per byte; then the peak stack of crypt_main of
+  *         the selected cipher. The static RAM of the image (.data, .bss,
+  *         SRAM2 sections) and the stack reserve of the linker script are
+  *         printed first; make stack lists the frames of -fstack-usage.
+  * @retval None
+  */
+static void BENCH_stack(void)
+{
+  const uint32_t* top = (const uint32_t*)__get_MSP();
+  uint32_t nrBlocks, tick, enc, setupStack, encStack, decStack;
+  uint32_t text[MAX_BLOCK_WORDS];
+  uint32_t i;
+  char encCpb[16];
+
+  BENCH_printf("data_bytes,bss_bytes,sram2_bytes,min_heap_bytes,min_stack_bytes\n\r");
+  BENCH_printf("%lu,%lu,%lu,%lu,%lu\n\r",
+               (uint32_t)(&_edata - &_sdata), (uint32_t)(&_ebss - &_sbss), (uint32_t)(&_esram2 - &_ssram2),
+               (uint32_t)&_Min_Heap_Size, (uint32_t)&_Min_Stack_Size);
+
+  BENCH_printf("cipher,key_bits,context_bytes,setup_stack_bytes,enc_stack_bytes,dec_stack_bytes,enc_cycles,enc_cpb,check\n\r");
+
+  for (i = 0; i < NR_CIPHERS; i++)
+  {
+    const BlockCipher* cipher = CIPHERS[i];
+    nrBlocks = BENCH_WORDS / cipher->blockWords;
+
+    paintStack();
+    cipher->init(&cipherContext, KEY, cipher->keyLen);
+    setupStack = stackUsed(top);
+
+    paintStack();
+    tick = KIN1_GetCycleCounter();
+    cipher->encrypt(&cipherContext, TEXT_LIST, cipherText, nrBlocks);
+    enc = KIN1_GetCycleCounter() - tick;
+    encStack = stackUsed(top);
+
+    paintStack();
+    cipher->decrypt(&cipherContext, cipherText, decryptedText, nrBlocks);
+    decStack = stackUsed(top);
+
+    BENCH_printf("%s,%u,%u,%lu,%lu,%lu,%lu,%s,%s\n\r",
+                 cipher->name, cipher->keyLen, cipher->contextBytes,
+                 setupStack, encStack, decStack, enc,
+                 cyclesPerByte(encCpb, enc, 4 * BENCH_WORDS),
+                 memcmp(decryptedText, TEXT_LIST, sizeof(decryptedText)) ? "FAIL" : "ok");
+  }
+
+  /* the one-shot path keeps its contexts on the stack; only its stack is
+     measured, its output is not checked */
+  memcpy(text, TEXT_LIST, sizeof(text));
+  paintStack();
+  crypt_main(text, KEY);
+  BENCH_printf("crypt_main,%u,-,-,%lu,-,-,-,-\n\r", KEYSIZE, stackUsed(top));
+}
+
+/**
+  * @brief  Run the benchmark selected with BENCHMARK in config.h
+  * @retval None
+  */
+void BENCH_run(void)
+{
+  switch (BENCHMARK)
+  {
+    case BENCH_ECB:
+      BENCH_ecb();
+      break;
+
+    case BENCH_CTR:
+      BENCH_ctr();
+      break;
+
+    case BENCH_CBC:
+      BENCH_cbc();
+      break;
+
+    case BENCH_GCM:
+      BENCH_gcm();
+      break;
+
+    case BENCH_CMAC:
+      BENCH_cmac();
+      break;
+
+    case BENCH_XTS:
+      BENCH_xts();
+      break;
+
+    case BENCH_STREAM:
+      BENCH_stream();
+      break;
+
+    case BENCH_BYTES:
+      BENCH_bytes();
+      break;
+
+    case BENCH_INPLACE:
+      BENCH_inplace();
+      break;
+
+    case BENCH_PLACEMENT:
+      BENCH_placement();
+      break;
+
+    case BENCH_CACHE:
+      BENCH_cache();
+      break;
+
+    case BENCH_CLOCK:
+      BENCH_clock();
+      break;
+
+    case BENCH_UART_DMA:
+      BENCH_uartDma();
+      break;
+
+    case BENCH_JOBS:
+#ifdef USE_CMSIS_RTOS2
+      /* the kernel owns PendSV, the job queue is never processed */
+      BENCH_printf("BENCH_JOBS runs on the bare metal build only\n\r");
+#else
+      BENCH_jobs();
+#endif
+      break;
+
+    case BENCH_LATENCY:
+      BENCH_latency();
+      break;
+
+    case BENCH_RTOS:
+#ifdef USE_CMSIS_RTOS2
+      BENCH_rtos();
+#else
+      BENCH_printf("BENCH_RTOS needs the CMSIS-RTOS2 build (make RTOS_SRC=...)\n\r");
+#endif
+      break;
+
+    case BENCH_RANDOM:
+      BENCH_random();
+      break;
+
+    case BENCH_REKEY:
+      BENCH_rekey();
+      break;
+
+    case BENCH_STACK:
+#ifdef USE_CMSIS_RTOS2
+      /* the threads have stacks of their own, not below the main stack */
+      BENCH_printf("BENCH_STACK measures the main stack of the bare metal build\n\r");
+#else
+      BENCH_stack();
+#endif
+      break;
+
+    default:
+      break;
+  }
+}
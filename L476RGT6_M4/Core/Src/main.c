@@ -40,6 +40,12 @@
 #include "GOST.h"
 #include "config.h"
 #include "constants.h"
+#include "benchmark.h"
+#include "jobqueue.h"
+#ifdef USE_CMSIS_RTOS2
+#include "cmsis_os2.h"
+#include "service.h"
+#endif
 
 /** @addtogroup STM32L4xx_HAL_LL_MIX_Examples
   * @{
@@ -51,39 +57,6 @@
 
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
-/* DWT (Data Watchpoint and Trace) registers, only exists on ARM Cortex with a DWT unit */
-
-#define KIN1_DWT_CONTROL             (*((volatile uint32_t*)0xE0001000))
-/*!< DWT Control register */
-#define KIN1_DWT_CYCCNTENA_BIT       (1UL<<0)
-/*!< CYCCNTENA bit in DWT_CONTROL register */
-#define KIN1_DWT_CYCCNT              (*((volatile uint32_t*)0xE0001004))
-/*!< DWT Cycle Counter register */
-#define KIN1_DEMCR                   (*((volatile uint32_t*)0xE000EDFC))
-/*!< DEMCR: Debug Exception and Monitor Control Register */
-#define KIN1_TRCENA_BIT              (1UL<<24)
-/*!< Trace enable bit in DEMCR register */
-
-#define KIN1_InitCycleCounter() \
-KIN1_DEMCR |= KIN1_TRCENA_BIT
-/*!< TRCENA: Enable trace and debug block DEMCR (Debug Exception and Monitor Control Register */
-
-#define KIN1_ResetCycleCounter() \
-KIN1_DWT_CYCCNT = 0
-/*!< Reset cycle counter */
-
-#define KIN1_EnableCycleCounter() \
-KIN1_DWT_CONTROL |= KIN1_DWT_CYCCNTENA_BIT
-/*!< Enable cycle counter */
-
-#define KIN1_DisableCycleCounter() \
-KIN1_DWT_CONTROL &= ~KIN1_DWT_CYCCNTENA_BIT
-/*!< Disable cycle counter */
-
-#define KIN1_GetCycleCounter() \
-KIN1_DWT_CYCCNT
-/*!< Read cycle counter register */
-
 uint32_t cycles; /* number of cycles */
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
@@ -104,9 +77,27 @@ __IO uint32_t uwBufferReadyIndication = 0;
 uint8_t *pBufferReadyForUser;
 uint8_t *pBufferReadyForReception;
 
+/* Crypto jobs submitted by interrupt handlers, run by PendSV */
+JobQueue cryptoJobs;
+
+#ifdef USE_CMSIS_RTOS2
+/* Thread running the benchmarks in the CMSIS-RTOS2 build */
+static const osThreadAttr_t benchmarkThreadAttr =
+{
+  .name = "benchmark",
+  .stack_size = 2048,
+  .priority = osPriorityNormal,
+};
+#endif
+
 /* Private function prototypes -----------------------------------------------*/
 static void SystemClock_Config(void);
 static void Error_Handler(void);
+static uint32_t JobQueue_Clock(void);
+static void JobQueue_Kick(void);
+#ifdef USE_CMSIS_RTOS2
+static void BenchmarkThread(void *argument);
+#endif
 
 /* Private functions ---------------------------------------------------------*/
 
@@ -168,9 +159,12 @@ int main(void)
   pBufferReadyForUser      = aRXBufferB;
   uwNbReceivedChars = 0;
   uwBufferReadyIndication = 0;
-  /* Enable RXNE and Error interrupts */  
+#if BENCHMARK != BENCH_UART_DMA
+  /* Enable RXNE and Error interrupts (the DMA pipeline takes the USART
+     interrupt over in BENCH_UART_DMA) */
   LL_USART_EnableIT_RXNE(USARTx);
   LL_USART_EnableIT_ERROR(USARTx);
+#endif
 
   /*##-3- Start the transmission process (using HAL Polling mode) #############*/  
   /* In main loop, Tx buffer is sent every 0.5 sec. 
@@ -180,11 +174,28 @@ int main(void)
   KIN1_InitCycleCounter(); /* enable DWT hardware */
   KIN1_ResetCycleCounter(); /* reset cycle counter */
   KIN1_EnableCycleCounter(); /* start counting */
+
+#ifdef USE_CMSIS_RTOS2
+  /*##-4- Start the kernel ###################################################*/
+  /* PendSV belongs to the kernel: the crypto service thread takes the place
+     of the job queue, and the benchmarks run in a thread */
+  osKernelInitialize();
+  SERVICE_init();
+  osThreadNew(BenchmarkThread, NULL, &benchmarkThreadAttr);
+  osKernelStart();
+#else
+  /*##-4- Start the crypto job queue ##########################################*/
+  /* PendSV at the lowest priority runs the jobs once the handlers that
+     submitted them have returned */
+  JOBQ_init(&cryptoJobs, JobQueue_Clock, JobQueue_Kick);
+  HAL_NVIC_SetPriority(PendSV_IRQn, 0x0F, 0);
+#endif
   while (1)
   {
-    
-    
-    
+#if BENCHMARK != BENCH_CRYPT_MAIN
+    BENCH_run();
+    HAL_Delay(1000);
+#else
     int ret;
     uint32_t tick,tock,spent,acc, count;
     uint8_t ret_string[32];
@@ -218,6 +229,7 @@ int main(void)
     acc=0;
     HAL_UART_Transmit(&UartHandle, (uint8_t*)ret_string, strlen(ret_string), 1000);
 	  HAL_Delay(1000);
+#endif
 	
 	
 	
@@ -298,6 +310,62 @@ static void Error_Handler(void)
   }
 }
 
+/**
+  * @brief  Timestamps of the crypto job queue, in core cycles.
+  * @retval Cycle counter
+  */
+static uint32_t JobQueue_Clock(void)
+{
+  return KIN1_GetCycleCounter();
+}
+
+/**
+  * @brief  Wakes up the consumer of the crypto job queue (PendSV_Handler).
+  * @retval None
+  */
+static void JobQueue_Kick(void)
+{
+  SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+}
+
+#ifdef USE_CMSIS_RTOS2
+/**
+  * @brief  Benchmark thread of the CMSIS-RTOS2 build
+  * @param  argument: unused
+  * @retval None
+  */
+static void BenchmarkThread(void *argument)
+{
+  for (;;)
+  {
+    BENCH_run();
+    osDelay(1000);
+  }
+}
+
+/**
+  * @brief  The kernel owns SysTick: no HAL tick interrupt. The HAL time base
+  *         is the cycle counter until the kernel runs, its tick (1 kHz) after.
+  * @param  TickPriority: unused
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_InitTick(uint32_t TickPriority)
+{
+  KIN1_InitCycleCounter();
+  KIN1_EnableCycleCounter();
+  return HAL_OK;
+}
+
+uint32_t HAL_GetTick(void)
+{
+  if (osKernelGetState() == osKernelRunning)
+  {
+    return osKernelGetTickCount();
+  }
+  return KIN1_GetCycleCounter() / (SystemCoreClock / 1000);
+}
+#endif
+
 /**
   * @brief  Rx Transfer completed callback
   * @note   This example shows a simple way to report end of IT Rx transfer, and 
@@ -0,0 +1,257 @@
+/**
+  ******************************************************************************
+  * @file    service.c
+  * @brief   Crypto service thread of the CMSIS-RTOS2 build (USE_CMSIS_RTOS2).
+  *          Clients post a pointer to their request on the queue of its
+  *          priority class and wait for a thread flag; the service thread
+  *          takes the interactive queue first, and runs bulk encryption in
+  *          chunks of SERVICE_CHUNK_BLOCKS blocks (chunked.h), serving the
+  *          interactive requests posted meanwhile between two chunks. The
+  *          contexts live in the sessions, only this thread touches them.
+  *          Interactive clients run above the service thread priority so
+  *          they can post while a bulk request is in progress.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "service.h"
+
+#ifdef USE_CMSIS_RTOS2
+#include "cmsis_os2.h"
+#include "chunked.h"
+
+/* Private define ------------------------------------------------------------*/
+#define SERVICE_OP_OPEN              0
+#define SERVICE_OP_CRYPT             1
+#define SERVICE_OP_CLOSE             2
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+  uint8_t op;
+  uint8_t priority;
+  uint8_t direction;
+  int32_t session;
+  const BlockCipher* cipher;   /* open */
+  const uint32_t* key;         /* open */
+  const uint32_t* in;
+  uint32_t* out;
+  uint32_t nrBlocks;
+  osThreadId_t client;
+  int32_t result;
+} ServiceRequest;
+
+typedef struct
+{
+  const BlockCipher* cipher;   /* NULL when the session is free */
+  CipherContext context;
+} ServiceSession;
+
+/* Private variables ---------------------------------------------------------*/
+static ServiceSession sessions[SERVICE_SESSIONS];
+static osMessageQueueId_t queues[2];
+static osSemaphoreId_t pending;   /* requests posted in both classes */
+static ChunkedContext chunkedContext;
+static ServiceSession* bulkSession;   /* session of the bulk request in progress */
+
+static const osThreadAttr_t serviceThreadAttr =
+{
+  .name = "crypto",
+  .stack_size = 1024,
+  .priority = osPriorityAboveNormal,
+};
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Serve one request and wake up its client
+  * @param  request: the request
+  * @param  preemptible: serve the interactive requests between the chunks
+  *         of an encryption
+  * @retval None
+  */
+static void serveRequest(ServiceRequest* request, uint8_t preemptible)
+{
+  ServiceSession* session = NULL;
+  ServiceRequest* urgent;
+  int32_t i;
+
+  if (request->op != SERVICE_OP_OPEN && request->session >= 0 && request->session < SERVICE_SESSIONS
+      && sessions[request->session].cipher != NULL)
+  {
+    session = &sessions[request->session];
+  }
+
+  request->result = -1;
+  switch (request->op)
+  {
+    case SERVICE_OP_OPEN:
+      for (i = 0; i < SERVICE_SESSIONS; i++)
+      {
+        if (sessions[i].cipher == NULL)
+        {
+          sessions[i].cipher = request->cipher;
+          request->cipher->init(&sessions[i].context, request->key, request->cipher->keyLen);
+          request->result = i;
+          break;
+        }
+      }
+      break;
+
+    case SERVICE_OP_CRYPT:
+      if (session == NULL)
+      {
+        break;
+      }
+      if (!preemptible)
+      {
+        if (request->direction == SERVICE_ENCRYPT)
+        {
+          session->cipher->encrypt(&session->context, request->in, request->out, request->nrBlocks);
+        }
+        else
+        {
+          session->cipher->decrypt(&session->context, request->in, request->out, request->nrBlocks);
+        }
+      }
+      else
+      {
+        bulkSession = session;
+        CHUNKED_init(&chunkedContext, session->cipher, &session->context, NULL,
+                     request->direction == SERVICE_ENCRYPT ? CHUNKED_ENCRYPT : CHUNKED_DECRYPT,
+                     request->in, request->out, request->nrBlocks);
+        while (CHUNKED_step(&chunkedContext, SERVICE_CHUNK_BLOCKS) != 0)
+        {
+          while (osMessageQueueGet(queues[SERVICE_INTERACTIVE], &urgent, NULL, 0) == osOK)
+          {
+            osSemaphoreAcquire(pending, 0);
+            serveRequest(urgent, 0);
+          }
+        }
+        bulkSession = NULL;
+      }
+      request->result = 0;
+      break;
+
+    case SERVICE_OP_CLOSE:
+      /* not under the bulk request still encrypting with it */
+      if (session == NULL || session == bulkSession)
+      {
+        break;
+      }
+      /* no expanded key left behind */
+      memset(&session->context, 0, sizeof(session->context));
+      session->cipher = NULL;
+      request->result = 0;
+      break;
+
+    default:
+      break;
+  }
+
+  osThreadFlagsSet(request->client, SERVICE_FLAG_DONE);
+}
+
+/**
+  * @brief  Service thread: one request per posted token, interactive first
+  * @param  argument: unused
+  * @retval None
+  */
+static void serviceThread(void* argument)
+{
+  ServiceRequest* request;
+
+  for (;;)
+  {
+    osSemaphoreAcquire(pending, osWaitForever);
+    if (osMessageQueueGet(queues[SERVICE_INTERACTIVE], &request, NULL, 0) != osOK
+        && osMessageQueueGet(queues[SERVICE_BULK], &request, NULL, 0) != osOK)
+    {
+      /* token of an interactive request already served during a bulk one */
+      continue;
+    }
+    serveRequest(request, request->priority == SERVICE_BULK);
+  }
+}
+
+/**
+  * @brief  Post a request and wait until it is served
+  * @retval Result of the request, -1 when it could not be posted
+  */
+static int32_t call(ServiceRequest* request)
+{
+  request->client = osThreadGetId();
+  osThreadFlagsClear(SERVICE_FLAG_DONE);
+
+  if (osMessageQueuePut(queues[request->priority], &request, 0, osWaitForever) != osOK)
+  {
+    return -1;
+  }
+  osSemaphoreRelease(pending);
+
+  osThreadFlagsWait(SERVICE_FLAG_DONE, osFlagsWaitAny, osWaitForever);
+  return request->result;
+}
+
+/**
+  * @brief  Create the queues and the service thread
+  * @retval None
+  */
+void SERVICE_init(void)
+{
+  queues[SERVICE_INTERACTIVE] = osMessageQueueNew(SERVICE_QUEUE_SIZE, sizeof(ServiceRequest*), NULL);
+  queues[SERVICE_BULK] = osMessageQueueNew(SERVICE_QUEUE_SIZE, sizeof(ServiceRequest*), NULL);
+  pending = osSemaphoreNew(2 * SERVICE_QUEUE_SIZE, 0, NULL);
+
+  if (queues[SERVICE_INTERACTIVE] == NULL || queues[SERVICE_BULK] == NULL || pending == NULL
+      || osThreadNew(serviceThread, NULL, &serviceThreadAttr) == NULL)
+  {
+    /* Initialization Error */
+    while(1);
+  }
+}
+
+/**
+  * @brief  Open a session: the service thread expands the key into a context
+  *         of its own
+  * @retval Session, -1 when all are in use
+  */
+int32_t SERVICE_open(const BlockCipher* cipher, const uint32_t* key)
+{
+  ServiceRequest request = { .op = SERVICE_OP_OPEN, .priority = SERVICE_INTERACTIVE, .cipher = cipher, .key = key };
+
+  return call(&request);
+}
+
+/**
+  * @brief  ECB over nrBlocks blocks with the context of the session (in place
+  *         allowed)
+  * @retval 0, -1 for a session not open or an unknown priority class
+  */
+int32_t SERVICE_crypt(int32_t session, uint8_t direction, uint8_t priority,
+                      const uint32_t* in, uint32_t* out, uint32_t nrBlocks)
+{
+  ServiceRequest request = { .op = SERVICE_OP_CRYPT, .priority = priority, .direction = direction,
+                             .session = session, .in = in, .out = out, .nrBlocks = nrBlocks };
+
+  if (priority != SERVICE_INTERACTIVE && priority != SERVICE_BULK)
+  {
+    return -1;
+  }
+  return call(&request);
+}
+
+/**
+  * @brief  Close a session and clear its context
+  * @retval 0, -1 for a session not open or in use by the bulk request in
+  *         progress
+  */
+int32_t SERVICE_close(int32_t session)
+{
+  ServiceRequest request = { .op = SERVICE_OP_CLOSE, .priority = SERVICE_INTERACTIVE, .session = session };
+
+  return call(&request);
+}
+
+#endif /* USE_CMSIS_RTOS2 */
@@ -19,6 +19,7 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "main.h"
+#include "config.h"
 
 /** @addtogroup STM32L4xx_HAL_LL_MIX_Examples
   * @{
@@ -32,6 +33,10 @@
 /* Private define ------------------------------------------------------------*/
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
+#if BENCHMARK == BENCH_UART_DMA
+static DMA_HandleTypeDef hdma_tx;
+static DMA_HandleTypeDef hdma_rx;
+#endif
 /* Private function prototypes -----------------------------------------------*/
 /* Private functions ---------------------------------------------------------*/
 
@@ -46,6 +51,8 @@
   *           - Peripheral's GPIO Configuration
   *           - Peripheral's GPIO Configuration  
   *           - NVIC configuration for UART interrupt request enable
+  *           - DMA configuration for transmission (normal) and reception
+  *             (circular) in the BENCH_UART_DMA mode
   * @param huart: UART handle pointer
   * @retval None
   */
@@ -76,8 +83,53 @@ void HAL_UART_MspInit(UART_HandleTypeDef *huart)
   GPIO_InitStruct.Alternate = USARTx_RX_AF;
 
   HAL_GPIO_Init(USARTx_RX_GPIO_PORT, &GPIO_InitStruct);
+
+#if BENCHMARK == BENCH_UART_DMA
+  /*##-3- Configure the DMA ##################################################*/
+  DMAx_CLK_ENABLE();
+
+  /* Configure the DMA handler for Transmission process */
+  hdma_tx.Instance                 = USARTx_TX_DMA_CHANNEL;
+  hdma_tx.Init.Request             = USARTx_TX_DMA_REQUEST;
+  hdma_tx.Init.Direction           = DMA_MEMORY_TO_PERIPH;
+  hdma_tx.Init.PeriphInc           = DMA_PINC_DISABLE;
+  hdma_tx.Init.MemInc              = DMA_MINC_ENABLE;
+  hdma_tx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+  hdma_tx.Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
+  hdma_tx.Init.Mode                = DMA_NORMAL;
+  hdma_tx.Init.Priority            = DMA_PRIORITY_LOW;
+
+  HAL_DMA_Init(&hdma_tx);
+
+  /* Associate the initialized DMA handle to the UART handle */
+  __HAL_LINKDMA(huart, hdmatx, hdma_tx);
+
+  /* Configure the DMA handler for reception process, into a circular buffer */
+  hdma_rx.Instance                 = USARTx_RX_DMA_CHANNEL;
+  hdma_rx.Init.Request             = USARTx_RX_DMA_REQUEST;
+  hdma_rx.Init.Direction           = DMA_PERIPH_TO_MEMORY;
+  hdma_rx.Init.PeriphInc           = DMA_PINC_DISABLE;
+  hdma_rx.Init.MemInc              = DMA_MINC_ENABLE;
+  hdma_rx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+  hdma_rx.Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
+  hdma_rx.Init.Mode                = DMA_CIRCULAR;
+  hdma_rx.Init.Priority            = DMA_PRIORITY_HIGH;
+
+  HAL_DMA_Init(&hdma_rx);
+
+  /* Associate the initialized DMA handle to the UART handle */
+  __HAL_LINKDMA(huart, hdmarx, hdma_rx);
+
+  /* NVIC configuration for DMA transfer complete interrupt (USARTx_TX) */
+  HAL_NVIC_SetPriority(USARTx_DMA_TX_IRQn, 0, 1);
+  HAL_NVIC_EnableIRQ(USARTx_DMA_TX_IRQn);
+
+  /* NVIC configuration for DMA half and full transfer interrupts (USARTx_RX) */
+  HAL_NVIC_SetPriority(USARTx_DMA_RX_IRQn, 0, 0);
+  HAL_NVIC_EnableIRQ(USARTx_DMA_RX_IRQn);
+#endif
     
-  /*##-3- Configure the NVIC for UART ########################################*/   
+  /*##-4- Configure the NVIC for UART ########################################*/   
   /* NVIC for USARTx */
   HAL_NVIC_SetPriority(USARTx_IRQn, 0, 1);
   HAL_NVIC_EnableIRQ(USARTx_IRQn);
@@ -102,11 +154,77 @@ void HAL_UART_MspDeInit(UART_HandleTypeDef *huart)
   HAL_GPIO_DeInit(USARTx_TX_GPIO_PORT, USARTx_TX_PIN);
   /* Configure UART Rx as alternate function  */
   HAL_GPIO_DeInit(USARTx_RX_GPIO_PORT, USARTx_RX_PIN);
+
+#if BENCHMARK == BENCH_UART_DMA
+  /*##-3- Disable the DMA ####################################################*/
+  /* De-Initialize the DMA channels associated to transmission and reception */
+  if(huart->hdmatx != NULL)
+  {
+    HAL_DMA_DeInit(huart->hdmatx);
+  }
+  if(huart->hdmarx != NULL)
+  {
+    HAL_DMA_DeInit(huart->hdmarx);
+  }
+
+  HAL_NVIC_DisableIRQ(USARTx_DMA_TX_IRQn);
+  HAL_NVIC_DisableIRQ(USARTx_DMA_RX_IRQn);
+#endif
   
-  /*##-3- Disable the NVIC for UART ##########################################*/
+  /*##-4- Disable the NVIC for UART ##########################################*/
   HAL_NVIC_DisableIRQ(USARTx_IRQn);
 }
 
+/**
+  * @brief RNG MSP Initialization
+  *        This function configures the hardware resources used in this example:
+  *           - 48 MHz RNG clock from PLLSAI1 (MSI 4 MHz * 24 / 2), the system
+  *             PLL is left untouched
+  *           - Peripheral's clock enable
+  * @param hrng: RNG handle pointer
+  * @retval None
+  */
+void HAL_RNG_MspInit(RNG_HandleTypeDef *hrng)
+{
+  RCC_PeriphCLKInitTypeDef PeriphClkInit = {0};
+
+  /*##-1- Select the RNG clock source ########################################*/
+  PeriphClkInit.PeriphClockSelection = RCC_PERIPHCLK_RNG;
+  PeriphClkInit.RngClockSelection = RCC_RNGCLKSOURCE_PLLSAI1;
+  PeriphClkInit.PLLSAI1.PLLSAI1Source = RCC_PLLSOURCE_MSI;
+  PeriphClkInit.PLLSAI1.PLLSAI1M = 1;
+  PeriphClkInit.PLLSAI1.PLLSAI1N = 24;
+  PeriphClkInit.PLLSAI1.PLLSAI1P = RCC_PLLP_DIV7;
+  PeriphClkInit.PLLSAI1.PLLSAI1Q = RCC_PLLQ_DIV2;
+  PeriphClkInit.PLLSAI1.PLLSAI1R = RCC_PLLR_DIV2;
+  PeriphClkInit.PLLSAI1.PLLSAI1ClockOut = RCC_PLLSAI1_48M2CLK;
+  if(HAL_RCCEx_PeriphCLKConfig(&PeriphClkInit) != HAL_OK)
+  {
+    /* Initialization Error */
+    while(1);
+  }
+
+  /*##-2- Enable peripheral clock ############################################*/
+  __HAL_RCC_RNG_CLK_ENABLE();
+}
+
+/**
+  * @brief RNG MSP De-Initialization
+  *        This function frees the hardware resources used in this example:
+  *          - Disable the Peripheral's clock
+  * @param hrng: RNG handle pointer
+  * @retval None
+  */
+void HAL_RNG_MspDeInit(RNG_HandleTypeDef *hrng)
+{
+  /*##-1- Reset peripherals ##################################################*/
+  __HAL_RCC_RNG_FORCE_RESET();
+  __HAL_RCC_RNG_RELEASE_RESET();
+
+  /*##-2- Disable peripheral clock ###########################################*/
+  __HAL_RCC_RNG_CLK_DISABLE();
+}
+
 /**
   * @}
   */
@@ -22,6 +22,9 @@
 /* Includes ------------------------------------------------------------------*/
 #include "main.h"
 #include "stm32l4xx_it.h"
+#include "config.h"
+#include "benchmark.h"
+#include "jobqueue.h"
 
 /** @addtogroup STM32L4xx_HAL_LL_MIX_Examples
   * @{
@@ -35,6 +38,9 @@
 /* Private define ------------------------------------------------------------*/
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
+/* UART handler declared in "main.c" file */
+extern UART_HandleTypeDef UartHandle;
+extern JobQueue cryptoJobs;
 /* Private function prototypes -----------------------------------------------*/
 /* Private functions ---------------------------------------------------------*/
 
@@ -103,6 +109,8 @@ void UsageFault_Handler(void)
   }
 }
 
+/* SVC, PendSV and SysTick belong to the kernel in the CMSIS-RTOS2 build */
+#ifndef USE_CMSIS_RTOS2
 /**
   * @brief  This function handles SVCall exception.
   * @param  None
@@ -111,6 +119,7 @@ void UsageFault_Handler(void)
 void SVC_Handler(void)
 {
 }
+#endif
 
 /**
   * @brief  This function handles Debug Monitor exception.
@@ -121,6 +130,7 @@ void DebugMon_Handler(void)
 {
 }
 
+#ifndef USE_CMSIS_RTOS2
 /**
   * @brief  This function handles PendSVC exception.
   * @param  None
@@ -128,6 +138,8 @@ void DebugMon_Handler(void)
   */
 void PendSV_Handler(void)
 {
+  /* Run the crypto jobs submitted by the interrupt handlers */
+  JOBQ_process(&cryptoJobs);
 }
 
 /**
@@ -139,6 +151,7 @@ void SysTick_Handler(void)
 {
   HAL_IncTick();
 }
+#endif
 
 /******************************************************************************/
 /*                 STM32L4xx Peripherals Interrupt Handlers                   */
@@ -154,6 +167,10 @@ void SysTick_Handler(void)
   */
 void USARTx_IRQHandler(void)
 {
+#if BENCHMARK == BENCH_UART_DMA
+  /* DMA transfers: HAL handles the errors and the end of transmission */
+  HAL_UART_IRQHandler(&UartHandle);
+#else
   /* Customize process using LL interface to improve the performance (exhaustive feature management not handled) */
 
   /* Check RXNE flag value in ISR register */
@@ -169,6 +186,46 @@ void USARTx_IRQHandler(void)
     /* Call Error function */
     UART_Error_Callback();
   }
+#endif
+}
+
+#if BENCHMARK == BENCH_UART_DMA
+/**
+  * @brief  This function handles DMA interrupt request for UART reception.
+  * @param  None
+  * @retval None
+  */
+void USARTx_DMA_RX_IRQHandler(void)
+{
+  HAL_DMA_IRQHandler(UartHandle.hdmarx);
+}
+
+/**
+  * @brief  This function handles DMA interrupt request for UART transmission.
+  * @param  None
+  * @retval None
+  */
+void USARTx_DMA_TX_IRQHandler(void)
+{
+  HAL_DMA_IRQHandler(UartHandle.hdmatx);
+}
+#endif
+
+/**
+  * @brief  This function handles the benchmark timer interrupt request.
+  * @param  None
+  * @retval None
+  */
+void BENCH_TIMx_IRQHandler(void)
+{
+  /* Counter read first: the distance to the compare value is the latency */
+  uint32_t counter = LL_TIM_GetCounter(BENCH_TIMx);
+
+  if(LL_TIM_IsActiveFlag_CC1(BENCH_TIMx))
+  {
+    LL_TIM_ClearFlag_CC1(BENCH_TIMx);
+    BENCH_Timer_Callback(counter);
+  }
 }
 
 /**
@@ -41,6 +41,13 @@ defined in linker script */
 .word	_sdata
 /* end address for the .data section. defined in linker script */
 .word	_edata
+/* start address for the initialization values of the .sram2 section.
+defined in linker script */
+.word	_sisram2
+/* start address for the .sram2 section. defined in linker script */
+.word	_ssram2
+/* end address for the .sram2 section. defined in linker script */
+.word	_esram2
 /* start address for the .bss section. defined in linker script */
 .word	_sbss
 /* end address for the .bss section. defined in linker script */
@@ -81,6 +88,23 @@ LoopCopyDataInit:
 	adds	r2, r0, r1
 	cmp	r2, r3
 	bcc	CopyDataInit
+
+/* Copy the sram2 segment initializers (code and tables placed in SRAM2) */
+	movs	r1, #0
+	b	LoopCopySram2Init
+
+CopySram2Init:
+	ldr	r3, =_sisram2
+	ldr	r3, [r3, r1]
+	str	r3, [r0, r1]
+	adds	r1, r1, #4
+
+LoopCopySram2Init:
+	ldr	r0, =_ssram2
+	ldr	r3, =_esram2
+	adds	r2, r0, r1
+	cmp	r2, r3
+	bcc	CopySram2Init
 	ldr	r2, =_sbss
 	b	LoopFillZerobss
 /* Zero fill the bss segment. */
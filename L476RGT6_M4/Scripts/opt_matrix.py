@@ -0,0 +1,91 @@
+# Optimisation level and compiler flag matrix: builds the firmware once per
+# configuration (make OPT=... LTO=... COMPILER=...), flashes it, records one
+# pass of the benchmark from the board and appends the flash and RAM
+# footprint of every cipher registry entry (size_report.py). The rows of all
+# the configurations are printed as one CSV, the configuration first.
+# Progress goes to stderr.
+#
+# usage: python3 opt_matrix.py [--benchmark BENCH_ECB] [--clang] [--build-only] [--port /dev/ttyACM0]
+#        (make matrix in Core, run from Core)
+
+import argparse
+import os
+import subprocess
+import sys
+
+# name, make variables
+CONFIGS = [
+	("O0", ["OPT=-O0"]),
+	("Os", ["OPT=-Os"]),
+	("O2", ["OPT=-O2"]),
+	("O3", ["OPT=-O3"]),
+	("Os_lto", ["OPT=-Os", "LTO=1"]),
+	("O2_lto", ["OPT=-O2", "LTO=1"]),
+]
+CLANG_CONFIGS = [
+	("clang_Os", ["OPT=-Os", "COMPILER=clang"]),
+	("clang_O2", ["OPT=-O2", "COMPILER=clang"]),
+	("clang_O3", ["OPT=-O3", "COMPILER=clang"]),
+]
+
+BAUD = 115200
+
+parser = argparse.ArgumentParser()
+parser.add_argument("--benchmark", default="BENCH_ECB")
+parser.add_argument("--clang", action="store_true", help="add the clang configurations")
+parser.add_argument("--build-only", action="store_true", help="sizes only, no board")
+parser.add_argument("--port", default="/dev/ttyACM0")
+args = parser.parse_args()
+
+sizeReport = os.path.join(os.path.dirname(os.path.abspath(__file__)), "size_report.py")
+project = os.path.basename(os.getcwd())
+
+def log(text):
+	print(text, file=sys.stderr)
+	sys.stderr.flush()
+
+def make(*targets):
+	subprocess.run(["make"] + list(targets), check=True, stdout=sys.stderr)
+
+# one pass of the benchmark: the lines from a CSV header to the next one
+def capturePass():
+	import serial # only needed with a board
+	ser = serial.Serial(args.port, BAUD, timeout=30)
+	ser.reset_input_buffer()
+	lines = []
+	while True:
+		line = ser.readline().decode("utf-8", "replace").strip()
+		if not line:
+			raise RuntimeError("no output from the board on " + args.port)
+		if line.startswith("cipher,"):
+			if lines:
+				ser.close()
+				return lines
+			lines = [line]
+		elif lines:
+			lines.append(line)
+
+configs = CONFIGS + (CLANG_CONFIGS if args.clang else [])
+header = None
+for name, variables in configs:
+	build = project + "_" + name
+	log("##### " + name + ": " + " ".join(variables))
+	make("elf", "hex", "PROJ_NAME=" + build, "BENCHMARK=" + args.benchmark, *variables)
+
+	report = [sys.executable, sizeReport, build + ".map", build + ".elf", "arm-none-eabi-"]
+	if not args.build_only:
+		make("flash", "PROJ_NAME=" + build)
+		with open(build + ".csv", "w") as results:
+			results.write("\n".join(capturePass()) + "\n")
+		report.append(build + ".csv")
+	rows = subprocess.run(report, check=True, stdout=subprocess.PIPE).stdout.decode("utf-8").splitlines()
+
+	# registry entry rows only, from the last cipher header on
+	start = max(index for index, row in enumerate(rows) if row.startswith("cipher,"))
+	if header is None:
+		header = "config," + rows[start]
+		print(header)
+	for row in rows[start + 1:]:
+		if row:
+			print(name + "," + row)
+	sys.stdout.flush()
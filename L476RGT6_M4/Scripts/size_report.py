@@ -0,0 +1,237 @@
+# Flash and RAM footprint of the firmware, per source module and per entry of
+# the cipher registry (cipher.h), printed as CSV.
+#
+# Modules: every input section of the map file (-Wl,-Map, one section per
+# function and per variable with -ffunction-sections -fdata-sections) is
+# counted in the output section holding it, and attributed to the source of
+# the symbols it defines (debug info, nm -l).
+# Registry entries: the functions reachable from the init, encrypt and
+# decrypt pointers of the entry (calls and literal pool addresses in the
+# disassembly) and the tables they reference. Code shared by several entries
+# is counted in each: the sizes are those of an image holding that entry
+# alone. enc_only_flash is the part an encrypt-only mode (CTR, CMAC, GCM)
+# keeps.
+#
+# With the CSV printed by the board (e.g. BENCH_ECB), the sizes of every
+# registry entry are appended to its rows instead, cycles and bytes in one
+# table.
+#
+# usage: python3 size_report.py map elf [toolchain prefix] [board csv]
+#        (make size-report [CSV=...] in Core)
+
+import re
+import struct
+import subprocess
+import sys
+
+# output sections of the linker script, by the memory they take
+SECTION_KIND = {
+	".isr_vector": "rodata", ".text": "text", ".rodata": "rodata",
+	".ARM.extab": "rodata", ".ARM": "rodata", ".preinit_array": "rodata",
+	".init_array": "rodata", ".fini_array": "rodata",
+	".data": "data", ".sram2": "data", ".bss": "bss",
+}
+KINDS = ["text", "rodata", "data", "bss"]
+
+# BlockCipher: name, blockWords, keyLen, init, encrypt, decrypt, contextBytes
+BLOCK_CIPHER = struct.Struct("<IBxHIIIH2x")
+
+FLASH_START = 0x08000000
+FLASH_END = 0x08100000
+
+mapFile = sys.argv[1]
+elfFile = sys.argv[2]
+prefix = sys.argv[3] if len(sys.argv) > 3 else "arm-none-eabi-"
+csvFile = sys.argv[4] if len(sys.argv) > 4 else None
+
+def run(*args):
+	return subprocess.run(args, check=True, stdout=subprocess.PIPE).stdout.decode("utf-8", "replace")
+
+def inFlash(address):
+	return FLASH_START <= address < FLASH_END
+
+##### Symbols: address, size, kind and source #####
+class Symbol:
+	def __init__(self, address, size, kind, name, source):
+		self.address = address
+		self.size = size
+		self.kind = kind
+		self.name = name
+		self.source = source
+
+symbols = []
+symbolRegex = re.compile(r"^([0-9a-f]+) ([0-9a-f]+) ([TtRrDdBb]) (\S+)(?:\t(\S+?):\d+)?$")
+for line in run(prefix + "nm", "-S", "-l", "--defined-only", elfFile).splitlines():
+	match = symbolRegex.match(line)
+	if not match or int(match.group(2), 16) == 0:
+		continue
+	address = int(match.group(1), 16)
+	kind = {"t": "text", "r": "rodata", "d": "data", "b": "bss"}[match.group(3).lower()]
+	if kind == "text":
+		address &= ~1 # Thumb bit
+		if not inFlash(address):
+			kind = "data" # placed in RAM (placement.h), copied from flash
+	source = match.group(5).replace("\\", "/").split("/")[-1] if match.group(5) else None
+	symbols.append(Symbol(address, int(match.group(2), 16), kind, match.group(4), source))
+symbols.sort(key=lambda symbol: symbol.address)
+starts = [symbol.address for symbol in symbols]
+
+def symbolAt(address):
+	for candidate in (address, address & ~1):
+		low, high = 0, len(starts)
+		while low < high:
+			middle = (low + high) // 2
+			if starts[middle] <= candidate:
+				low = middle + 1
+			else:
+				high = middle
+		if low and candidate < symbols[low - 1].address + symbols[low - 1].size:
+			return symbols[low - 1]
+	return None
+
+##### Map file: input sections per object #####
+# (section kind, address, size, object)
+sections = []
+section = None
+pending = None
+inputRegex = re.compile(r"^ (\S+)?\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)\s+(\S.*)$")
+with open(mapFile) as lines:
+	for line in lines:
+		if line.startswith("Linker script and memory map"):
+			section = ""
+			continue
+		if section is None:
+			continue
+		line = line.rstrip()
+		if re.match(r"^\.\S+", line):
+			section = line.split()[0]
+			continue
+		match = inputRegex.match(line)
+		if match:
+			name = match.group(1) or pending
+			pending = None
+			if name and name != "*fill*" and section in SECTION_KIND and int(match.group(3), 16):
+				sections.append((SECTION_KIND[section], int(match.group(2), 16), int(match.group(3), 16), match.group(4)))
+		elif re.match(r"^ \S+$", line):
+			pending = line.strip() # long section name, address and size on the next line
+
+# object to module: the source most of its symbols come from (the objects
+# of the one command build are temporary files), archives by name
+votes = {}
+low = 0
+for kind, address, size, objectFile in sorted(sections, key=lambda section: section[1]):
+	while low < len(symbols) and symbols[low].address < address:
+		low += 1
+	index = low
+	while index < len(symbols) and symbols[index].address < address + size:
+		if symbols[index].source:
+			count = votes.setdefault(objectFile, {})
+			count[symbols[index].source] = count.get(symbols[index].source, 0) + 1
+		index += 1
+
+modules = {}
+for kind, address, size, objectFile in sections:
+	archive = re.match(r"^.*?([^/\\]+\.a)\(", objectFile)
+	count = votes.get(objectFile)
+	if archive:
+		module = archive.group(1)
+	elif count:
+		# nm -l may give the header declaring a function instead of its source
+		module = max(count, key=lambda source: (not source.endswith(".h"), count[source]))
+	else:
+		module = objectFile.replace("\\", "/").split("/")[-1]
+	modules.setdefault(module, dict.fromkeys(KINDS, 0))[kind] += size
+
+def sizeColumns(sizes):
+	flash = sizes["text"] + sizes["rodata"] + sizes["data"]
+	ram = sizes["data"] + sizes["bss"]
+	return [sizes[kind] for kind in KINDS] + [flash, ram]
+
+##### Registry entries: read from the image #####
+elf = open(elfFile, "rb").read()
+sectionOffset = struct.unpack_from("<I", elf, 0x20)[0]
+sectionSize, _, sectionCount = struct.unpack_from("<HHH", elf, 0x2E)
+loadable = []
+for index in range(sectionCount):
+	_, kind, _, address, offset, size = struct.unpack_from("<IIIIII", elf, sectionOffset + index * sectionSize)
+	if kind == 1 and address: # SHT_PROGBITS
+		loadable.append((address, offset, size))
+
+def readImage(address, length):
+	for start, offset, size in loadable:
+		if start <= address and address + length <= start + size:
+			return elf[offset + address - start : offset + address - start + length]
+	return None
+
+def readString(address):
+	text = b""
+	while True:
+		byte = readImage(address + len(text), 1)
+		if not byte or byte == b"\0":
+			return text.decode("utf-8", "replace")
+		text += byte
+
+# call graph: every address a function branches to or loads from its literal pool
+references = {}
+current = None
+referenceRegex = re.compile(r"\b([0-9a-f]+) <[^>]+>|\.word\s+0x([0-9a-f]+)")
+for line in run(prefix + "objdump", "-d", "--no-show-raw-insn", elfFile).splitlines():
+	header = re.match(r"^([0-9a-f]+) <(.+)>:$", line)
+	if header:
+		current = symbolAt(int(header.group(1), 16))
+		continue
+	if current is None or ":" not in line:
+		continue
+	for match in referenceRegex.finditer(line.split(":", 1)[1]):
+		target = symbolAt(int(match.group(1) or match.group(2), 16))
+		if target is not None and target is not current:
+			references.setdefault(current, set()).add(target)
+
+def reachable(roots):
+	seen = set()
+	stack = [root for root in roots if root is not None]
+	while stack:
+		symbol = stack.pop()
+		if symbol in seen:
+			continue
+		seen.add(symbol)
+		stack.extend(references.get(symbol, ()))
+	return seen
+
+def sizesOf(reached):
+	sizes = dict.fromkeys(KINDS, 0)
+	for symbol in reached:
+		sizes[symbol.kind] += symbol.size
+	return sizes
+
+entries = {}
+for symbol in symbols:
+	if not symbol.name.endswith("_CIPHER") or symbol.size != BLOCK_CIPHER.size:
+		continue
+	name, blockWords, keyLen, init, encrypt, decrypt, contextBytes = BLOCK_CIPHER.unpack(readImage(symbol.address, BLOCK_CIPHER.size))
+	init, encrypt, decrypt = (symbolAt(pointer & ~1) for pointer in (init, encrypt, decrypt))
+	total = sizeColumns(sizesOf(reachable([init, encrypt, decrypt])))
+	encOnly = sizeColumns(sizesOf(reachable([init, encrypt])))
+	entries[readString(name)] = [symbol.source or "?"] + total + [encOnly[4], contextBytes]
+
+##### Report #####
+ENTRY_COLUMNS = ["module", "text_bytes", "rodata_bytes", "data_bytes", "bss_bytes", "flash_bytes", "ram_bytes", "enc_only_flash_bytes", "context_bytes"]
+
+if csvFile:
+	with open(csvFile) as lines:
+		for line in lines:
+			line = line.strip()
+			fields = line.split(",")
+			if fields[0] == "cipher":
+				line += "," + ",".join(ENTRY_COLUMNS)
+			elif fields[0] in entries:
+				line += "," + ",".join(str(value) for value in entries[fields[0]])
+			print(line)
+else:
+	print("module,text_bytes,rodata_bytes,data_bytes,bss_bytes,flash_bytes,ram_bytes")
+	for module in sorted(modules, key=lambda module: -sizeColumns(modules[module])[4]):
+		print(",".join([module] + [str(value) for value in sizeColumns(modules[module])]))
+	print("")
+	print("cipher," + ",".join(ENTRY_COLUMNS))
+	for name in entries:
+		print(",".join([name] + [str(value) for value in entries[name]]))
@@ -0,0 +1,47 @@
+# Host side of the BENCH_UART_DMA mode: waits for the prompt of the board,
+# sends random data at the announced baud rate while reading back the
+# encrypted echo, then prints the result line of the board.
+#
+# usage: python3 uart_dma_stream.py [port]    (default /dev/ttyACM0)
+
+import os
+import serial
+import sys
+import threading
+import time
+
+PROMPT_BAUD = 115200
+
+port = sys.argv[1] if len(sys.argv) > 1 else "/dev/ttyACM0"
+ser = serial.Serial(port, PROMPT_BAUD, timeout=15)
+
+def readLine():
+	return ser.readline().decode("utf-8", "replace").strip()
+
+def sendData(data):
+	ser.write(data)
+	ser.flush()
+
+while True:
+	line = readLine()
+	if not line.startswith("uart_dma,"):
+		continue
+
+	baud, length = [int(x) for x in line.split(",")[1:3]]
+	data = os.urandom(length)
+
+	ser.baudrate = baud
+	time.sleep(0.1)
+	ser.reset_input_buffer()
+
+	writer = threading.Thread(target=sendData, args=(data,))
+	writer.start()
+	echo = ser.read(length)
+	writer.join()
+
+	ser.baudrate = PROMPT_BAUD
+	header = readLine()
+	result = readLine()
+	print(header)
+	print(result)
+	print("host: sent %d bytes, received %d at %d baud" % (length, len(echo), baud))
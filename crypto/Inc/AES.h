@@ -9,9 +9,25 @@
 
 #include <stdio.h>
 #include <stdint.h>
+#include "config.h"
 
 #define INPUT_SIZE 12000
 
+#ifdef USE_AES
+
+typedef struct
+{
+	uint8_t Nk;
+	uint8_t Nr;
+	uint8_t roundKey[240];
+} AesContext;
+
+void AES_init(AesContext* context, const uint32_t* key, uint16_t keyLen);
+void AES_encrypt(AesContext* context, const uint32_t* input, uint32_t* output);
+void AES_decrypt(AesContext* context, const uint32_t* input, uint32_t* output);
+
+#endif
+
 
 
 int app_main(double*, uint32_t*);
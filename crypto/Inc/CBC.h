@@ -0,0 +1,17 @@
+/* CBC.h
+*
+ * Cipher block chaining mode over the block cipher interface (cipher.h).
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "cipher.h"
+
+// blocks handed to the cipher per call when decrypting
+#define CBC_DECRYPT_BLOCKS 4
+
+// iv is updated with the last ciphertext block, so consecutive calls chain (in place allowed)
+void CBC_encrypt(const BlockCipher* cipher, CipherContext* key, uint32_t* iv, const uint32_t* in, uint32_t* out, uint32_t nrBlocks);
+void CBC_decrypt(const BlockCipher* cipher, CipherContext* key, uint32_t* iv, const uint32_t* in, uint32_t* out, uint32_t nrBlocks);
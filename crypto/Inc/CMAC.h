@@ -0,0 +1,28 @@
+/* CMAC.h
+*
+ * CMAC message authentication (NIST SP 800-38B) over the block cipher
+ * interface (cipher.h), for 64 and 128 bits blocks.
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "cipher.h"
+
+typedef struct
+{
+	const BlockCipher* cipher;
+	CipherContext* key;              // expanded with cipher->init by the caller
+	uint32_t k1[MAX_BLOCK_WORDS];    // subkeys, derived once per key
+	uint32_t k2[MAX_BLOCK_WORDS];
+	uint32_t x[MAX_BLOCK_WORDS];     // chaining value
+	uint8_t buffer[4 * MAX_BLOCK_WORDS];
+	uint8_t bufferLen;               // bytes in buffer, the last block is always kept
+} CmacContext;
+
+void CMAC_init(CmacContext* context, const BlockCipher* cipher, CipherContext* key);
+void CMAC_update(CmacContext* context, const uint8_t* data, uint32_t len);
+
+// writes 4 * blockWords bytes and starts a new message with the same subkeys
+void CMAC_final(CmacContext* context, uint8_t* mac);
@@ -0,0 +1,32 @@
+/* CTR.h
+*
+ * Counter mode over the block cipher interface (cipher.h).
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "cipher.h"
+
+// keystream buffer, in 32-bit words (a multiple of every block length)
+#define CTR_KEYSTREAM_WORDS 64
+
+typedef struct
+{
+	const BlockCipher* cipher;
+	CipherContext* key;                    // expanded with cipher->init by the caller
+	uint32_t counter[MAX_BLOCK_WORDS];     // next counter block
+	uint32_t keystream[CTR_KEYSTREAM_WORDS];
+	uint32_t available;                    // keystream words in the buffer
+	uint32_t position;                     // next unused keystream word
+} CtrContext;
+
+void CTR_init(CtrContext* context, const BlockCipher* cipher, CipherContext* key, const uint32_t* nonce);
+
+// fill the keystream buffer ahead of time (idle time or low priority context)
+void CTR_prefill(CtrContext* context);
+
+// encrypt or decrypt nrWords words, generating keystream when the buffer runs out
+// (in place allowed)
+void CTR_crypt(CtrContext* context, const uint32_t* in, uint32_t* out, uint32_t nrWords);
@@ -0,0 +1,40 @@
+/* GCM.h
+*
+ * Galois/counter mode authenticated encryption over the block cipher
+ * interface (cipher.h), for the ciphers with a 128 bits block.
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "cipher.h"
+#include "CTR.h"
+
+#define GCM_IV_WORDS  3 // 96 bits IV
+#define GCM_TAG_WORDS 4
+
+typedef struct
+{
+	const BlockCipher* cipher;
+	CipherContext* key;      // expanded with cipher->init by the caller
+	uint8_t constantTime;    // GHASH table read without key or data dependent addresses
+	uint32_t table[16][4];   // Shoup 4-bit table: table[i] = i * H
+	uint32_t j0[4];          // pre-counter block
+	uint32_t y[4];           // GHASH accumulator
+	CtrContext ctr;
+} GcmContext;
+
+// computes H and its table, once per key
+void GCM_init(GcmContext* context, const BlockCipher* cipher, CipherContext* key, uint8_t constantTime);
+
+// in place allowed, the ciphertext is hashed after encryption and before decryption
+void GCM_encrypt(GcmContext* context, const uint32_t* iv, const uint32_t* aad, uint32_t aadWords,
+	const uint32_t* in, uint32_t* out, uint32_t nrWords, uint32_t* tag);
+
+// returns 0 when the tag matches, -1 otherwise (out must then be discarded)
+int GCM_decrypt(GcmContext* context, const uint32_t* iv, const uint32_t* aad, uint32_t aadWords,
+	const uint32_t* in, uint32_t* out, uint32_t nrWords, const uint32_t* tag);
+
+// GHASH of nrWords words into the accumulator, last block zero padded
+void GCM_ghash(GcmContext* context, const uint32_t* data, uint32_t nrWords);
@@ -22,6 +22,8 @@ typedef struct
 void HIGHT_init(HightContext* context, uint8_t* key);
 void HIGHT_encrypt(HightContext* context, uint8_t* block, uint8_t* out);
 void HIGHT_decrypt(HightContext* context, uint8_t* block, uint8_t* out);
+void HIGHT_encrypt_ecb(HightContext* context, const uint8_t* blocks, uint8_t* out, uint32_t nrBlocks);
+void HIGHT_decrypt_ecb(HightContext* context, const uint8_t* blocks, uint8_t* out, uint32_t nrBlocks);
 
 int crypt_main(uint32_t* text, uint32_t* key);
 
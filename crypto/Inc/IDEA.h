@@ -23,6 +23,8 @@ typedef struct
 void IDEA_init(IdeaContext* context, uint16_t* key);
 void IDEA_encrypt(IdeaContext* context, uint16_t* block, uint16_t* out);
 void IDEA_decrypt(IdeaContext* context, uint16_t* encryptedBlock, uint16_t* out);
+void IDEA_encrypt_ecb(IdeaContext* context, const uint16_t* blocks, uint16_t* out, uint32_t nrBlocks);
+void IDEA_decrypt_ecb(IdeaContext* context, const uint16_t* encryptedBlocks, uint16_t* out, uint32_t nrBlocks);
 
 int crypt_main(uint32_t* text, uint32_t* key);
 
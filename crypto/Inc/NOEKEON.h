@@ -13,9 +13,24 @@
 
 #ifdef USE_NOEKEON
 
+// key schedule variants of the specification
+#define NOEKEON_DIRECT   0 // the working key is the cipher key
+#define NOEKEON_INDIRECT 1 // the working key is the cipher key encrypted under the null key
+
+typedef struct
+{
+	uint32_t encryptionKey[4]; // working key
+	uint32_t decryptionKey[4]; // theta(NULL_VECTOR, working key)
+} NoekeonContext;
+
 void NOEKEON_encrypt(uint32_t* block, uint32_t* key, uint32_t* encryptdBlock);
 void NOEKEON_decrypt(uint32_t* encryptedBlock, uint32_t* key, uint32_t* decryptedBlock);
 
+// precomputed working keys and 16 unrolled rounds over nrBlocks blocks (in place allowed)
+void NOEKEON_init(NoekeonContext* context, const uint32_t* key, uint8_t mode);
+void NOEKEON_encrypt_ecb(NoekeonContext* context, const uint32_t* blocks, uint32_t* out, uint32_t nrBlocks);
+void NOEKEON_decrypt_ecb(NoekeonContext* context, const uint32_t* blocks, uint32_t* out, uint32_t nrBlocks);
+
 int crypt_main(uint32_t* text, uint32_t* key);
 
 
@@ -19,10 +19,30 @@ typedef struct
 	uint64_t subkeys[72];
 } SimonContext;
 
+// Simon64: 64 bits block on 32-bit words, 96/128 bits key
+typedef struct
+{
+	uint8_t nrSubkeys;
+	uint32_t subkeys[44];
+} Simon64Context;
+
 void SIMON_init(SimonContext* context, uint64_t* key, uint16_t keyLen);
 void SIMON_encrypt(SimonContext* context, uint64_t* block, uint64_t* out);
 void SIMON_decrypt(SimonContext* context, uint64_t* block, uint64_t* out);
 
+// Simon128 on 32-bit register pairs over nrBlocks blocks of 4 words,
+// most significant word first (in place allowed)
+void SIMON_encrypt_ecb(SimonContext* context, const uint32_t* blocks, uint32_t* out, uint32_t nrBlocks);
+void SIMON_decrypt_ecb(SimonContext* context, const uint32_t* blocks, uint32_t* out, uint32_t nrBlocks);
+
+// same as SIMON_encrypt_ecb with the rounds fully unrolled for the key length
+void SIMON_encrypt_unrolled(SimonContext* context, const uint32_t* blocks, uint32_t* out, uint32_t nrBlocks);
+void SIMON_decrypt_unrolled(SimonContext* context, const uint32_t* blocks, uint32_t* out, uint32_t nrBlocks);
+
+void SIMON64_init(Simon64Context* context, const uint32_t* key, uint16_t keyLen);
+void SIMON64_encrypt(Simon64Context* context, const uint32_t* block, uint32_t* out);
+void SIMON64_decrypt(Simon64Context* context, const uint32_t* block, uint32_t* out);
+
 int crypt_main(uint32_t* text, uint32_t* key);
 
 #endif
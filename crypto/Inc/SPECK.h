@@ -20,10 +20,30 @@ typedef struct
 	uint64_t subkeys[34];
 } SpeckContext;
 
+// Speck64: 64 bits block on 32-bit words, 96/128 bits key
+typedef struct
+{
+	uint8_t nrSubkeys;
+	uint32_t subkeys[27];
+} Speck64Context;
+
 void SPECK_init(SpeckContext* context, uint64_t* key, uint16_t keyLen);
 void SPECK_encrypt(SpeckContext* context, uint64_t* block, uint64_t* out);
 void SPECK_decrypt(SpeckContext* context, uint64_t* block, uint64_t* out);
 
+// Speck128 on 32-bit register pairs over nrBlocks blocks of 4 words,
+// most significant word first (in place allowed)
+void SPECK_encrypt_ecb(SpeckContext* context, const uint32_t* blocks, uint32_t* out, uint32_t nrBlocks);
+void SPECK_decrypt_ecb(SpeckContext* context, const uint32_t* blocks, uint32_t* out, uint32_t nrBlocks);
+
+// same as SPECK_encrypt_ecb with the rounds fully unrolled for the key length
+void SPECK_encrypt_unrolled(SpeckContext* context, const uint32_t* blocks, uint32_t* out, uint32_t nrBlocks);
+void SPECK_decrypt_unrolled(SpeckContext* context, const uint32_t* blocks, uint32_t* out, uint32_t nrBlocks);
+
+void SPECK64_init(Speck64Context* context, const uint32_t* key, uint16_t keyLen);
+void SPECK64_encrypt(Speck64Context* context, const uint32_t* block, uint32_t* out);
+void SPECK64_decrypt(Speck64Context* context, const uint32_t* block, uint32_t* out);
+
 int crypt_main(uint32_t* text, uint32_t* key);
 
 #endif
@@ -0,0 +1,27 @@
+/* XTS.h
+*
+ * XTS mode (IEEE 1619) for sector encryption over the block cipher
+ * interface (cipher.h), for the ciphers with a 128 bits block.
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "cipher.h"
+
+// blocks whose tweaks are computed ahead and handed to the cipher per call
+#define XTS_CHUNK_BLOCKS 8
+
+typedef struct
+{
+	const BlockCipher* cipher;
+	CipherContext* dataKey;   // both expanded with cipher->init by the caller
+	CipherContext* tweakKey;
+} XtsContext;
+
+void XTS_init(XtsContext* context, const BlockCipher* cipher, CipherContext* dataKey, CipherContext* tweakKey);
+
+// sectorBytes is a multiple of 16, typically 512 or 4096 (in place allowed)
+void XTS_encrypt_sector(XtsContext* context, uint64_t sector, const uint32_t* in, uint32_t* out, uint32_t sectorBytes);
+void XTS_decrypt_sector(XtsContext* context, uint64_t sector, const uint32_t* in, uint32_t* out, uint32_t sectorBytes);
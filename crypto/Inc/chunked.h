@@ -0,0 +1,37 @@
+/* chunked.h
+*
+ * Resumable ECB and CTR over long buffers (cipher.h, CTR.h). Every step
+ * processes at most a given number of blocks and keeps the position in the
+ * context, so a cooperative task (protothread style) yields between steps
+ * and bounds how long it holds the CPU, or masks the interrupts for.
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "cipher.h"
+#include "CTR.h"
+
+#define CHUNKED_ENCRYPT 0
+#define CHUNKED_DECRYPT 1
+
+typedef struct
+{
+	const BlockCipher* cipher;
+	CipherContext* key;          // expanded with cipher->init by the caller
+	CtrContext* ctr;             // CTR when set (direction unused), ECB otherwise
+	uint8_t direction;
+	const uint32_t* in;          // next block
+	uint32_t* out;
+	uint32_t blocksLeft;
+} ChunkedContext;
+
+// ctr: initialised with CTR_init, NULL for ECB. out == in allowed
+void CHUNKED_init(ChunkedContext* context, const BlockCipher* cipher, CipherContext* key, CtrContext* ctr,
+	uint8_t direction, const uint32_t* in, uint32_t* out, uint32_t nrBlocks);
+
+// processes at most maxBlocks blocks, returns the blocks left (0 when done).
+// In CTR a step also refills the keystream buffer when it runs out, up to
+// CTR_KEYSTREAM_WORDS words of cipher work
+uint32_t CHUNKED_step(ChunkedContext* context, uint32_t maxBlocks);
@@ -0,0 +1,168 @@
+/* cipher.h
+*
+ * Common interface to the block ciphers selected in config.h.
+ *
+ * Every cipher (and every optimised backend of a cipher) registers one
+ * BlockCipher entry per key length in CIPHERS. Blocks and keys are passed
+ * as 32-bit words in the same packing crypt_main uses: text[0] holds the
+ * first 4 bytes of the block, most significant byte first.
+ * CIPHER_encrypt_bytes/CIPHER_decrypt_bytes give the same ECB on byte
+ * buffers in the order of the cipher specifications.
+ *
+ * Every encrypt and decrypt, one block or many, and the modes built on
+ * them, accept out == in: a block is read whole before its result is
+ * written, so buffers are processed in place without a copy.
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "config.h"
+#include "AES.h"
+#include "ARIA.h"
+#include "CAMELLIA.h"
+#include "GOST.h"
+#include "HIGHT.h"
+#include "IDEA.h"
+#include "NOEKEON.h"
+#include "PRESENT.h"
+#include "SEED.h"
+#include "SIMON.h"
+#include "SPECK.h"
+
+// largest block handled by the ciphers, in 32-bit words
+#define MAX_BLOCK_WORDS 4
+
+// blocks repacked and handed to the cipher per call by the byte API
+#define CIPHER_CHUNK_BLOCKS 8
+
+// Expanded key of any of the compiled ciphers
+typedef union
+{
+	// ciphers keyed directly with the key words (GOST, reference NOEKEON)
+	uint32_t rawKey[8];
+#ifdef USE_AES
+	AesContext aes;
+#endif
+#ifdef USE_ARIA
+	AriaContext aria;
+#endif
+#ifdef USE_CAMELLIA
+	CamelliaContext camellia;
+#endif
+#ifdef USE_HIGHT
+	HightContext hight;
+#endif
+#ifdef USE_IDEA
+	IdeaContext idea;
+#endif
+#ifdef USE_NOEKEON
+	NoekeonContext noekeon;
+#endif
+#ifdef USE_PRESENT
+	PresentContext present;
+#endif
+#ifdef USE_SEED
+	SeedContext seed;
+#endif
+#ifdef USE_SIMON
+	SimonContext simon;
+	Simon64Context simon64;
+#endif
+#ifdef USE_SPECK
+	SpeckContext speck;
+	Speck64Context speck64;
+#endif
+} CipherContext;
+
+typedef struct
+{
+	const char* name;
+	uint8_t blockWords; // block length in 32-bit words
+	uint16_t keyLen;    // key length in bits
+
+	void (*init)(CipherContext* context, const uint32_t* key, uint16_t keyLen);
+
+	// ECB over nrBlocks consecutive blocks (in place allowed)
+	void (*encrypt)(CipherContext* context, const uint32_t* in, uint32_t* out, uint32_t nrBlocks);
+	void (*decrypt)(CipherContext* context, const uint32_t* in, uint32_t* out, uint32_t nrBlocks);
+
+	uint16_t contextBytes; // part of the CipherContext the expanded key takes
+} BlockCipher;
+
+extern const BlockCipher* const CIPHERS[];
+extern const uint32_t NR_CIPHERS;
+
+// byte buffers (any alignment) to and from the word packing, one REV per word
+void CIPHER_load_words(const uint8_t* bytes, uint32_t* words, uint32_t nrWords);
+void CIPHER_store_words(const uint32_t* words, uint8_t* bytes, uint32_t nrWords);
+
+// ECB over nrBlocks blocks of a byte buffer (any alignment, in place allowed)
+void CIPHER_encrypt_bytes(const BlockCipher* cipher, CipherContext* context, const uint8_t* in, uint8_t* out, uint32_t nrBlocks);
+void CIPHER_decrypt_bytes(const BlockCipher* cipher, CipherContext* context, const uint8_t* in, uint8_t* out, uint32_t nrBlocks);
+
+#ifdef USE_AES
+extern const BlockCipher AES_128_CIPHER;
+extern const BlockCipher AES_192_CIPHER;
+extern const BlockCipher AES_256_CIPHER;
+#endif
+#ifdef USE_ARIA
+extern const BlockCipher ARIA_128_CIPHER;
+extern const BlockCipher ARIA_192_CIPHER;
+extern const BlockCipher ARIA_256_CIPHER;
+#endif
+#ifdef USE_CAMELLIA
+extern const BlockCipher CAMELLIA_128_CIPHER;
+extern const BlockCipher CAMELLIA_192_CIPHER;
+extern const BlockCipher CAMELLIA_256_CIPHER;
+#endif
+#ifdef USE_GOST
+extern const BlockCipher GOST_CIPHER;
+#endif
+#ifdef USE_HIGHT
+extern const BlockCipher HIGHT_CIPHER;
+extern const BlockCipher HIGHT_X4_CIPHER;
+#endif
+#ifdef USE_IDEA
+extern const BlockCipher IDEA_CIPHER;
+extern const BlockCipher IDEA_X2_CIPHER;
+#endif
+#ifdef USE_NOEKEON
+extern const BlockCipher NOEKEON_CIPHER;
+extern const BlockCipher NOEKEON_DIRECT_CIPHER;
+extern const BlockCipher NOEKEON_INDIRECT_CIPHER;
+#endif
+#ifdef USE_PRESENT
+extern const BlockCipher PRESENT_80_CIPHER;
+extern const BlockCipher PRESENT_128_CIPHER;
+#endif
+#ifdef USE_SEED
+extern const BlockCipher SEED_CIPHER;
+#endif
+#ifdef USE_SIMON
+extern const BlockCipher SIMON_128_CIPHER;
+extern const BlockCipher SIMON_192_CIPHER;
+extern const BlockCipher SIMON_256_CIPHER;
+extern const BlockCipher SIMON_128_PAIR_CIPHER;
+extern const BlockCipher SIMON_192_PAIR_CIPHER;
+extern const BlockCipher SIMON_256_PAIR_CIPHER;
+extern const BlockCipher SIMON_128_UNROLLED_CIPHER;
+extern const BlockCipher SIMON_192_UNROLLED_CIPHER;
+extern const BlockCipher SIMON_256_UNROLLED_CIPHER;
+extern const BlockCipher SIMON64_96_CIPHER;
+extern const BlockCipher SIMON64_128_CIPHER;
+#endif
+#ifdef USE_SPECK
+extern const BlockCipher SPECK_128_CIPHER;
+extern const BlockCipher SPECK_192_CIPHER;
+extern const BlockCipher SPECK_256_CIPHER;
+extern const BlockCipher SPECK_128_PAIR_CIPHER;
+extern const BlockCipher SPECK_192_PAIR_CIPHER;
+extern const BlockCipher SPECK_256_PAIR_CIPHER;
+extern const BlockCipher SPECK_128_UNROLLED_CIPHER;
+extern const BlockCipher SPECK_192_UNROLLED_CIPHER;
+extern const BlockCipher SPECK_256_UNROLLED_CIPHER;
+extern const BlockCipher SPECK64_96_CIPHER;
+extern const BlockCipher SPECK64_128_CIPHER;
+#endif
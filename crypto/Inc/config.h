@@ -78,3 +78,103 @@ Speck 128/192/256
 
 
 
+
+/*
+Placement of the round functions and lookup tables of the ciphers (placement.h):
+
+PLACE_FLASH   in flash with the rest of the code, behind the ART accelerator
+PLACE_SRAM1   copied to SRAM1 at startup
+PLACE_SRAM2   copied to SRAM2 at startup
+
+Can be given on the make command line, e.g. make PLACEMENT=PLACE_SRAM2
+*/
+#define PLACE_FLASH 0
+#define PLACE_SRAM1 1
+#define PLACE_SRAM2 2
+
+#ifndef PLACEMENT
+#define PLACEMENT PLACE_FLASH
+#endif
+
+/*
+Benchmark modes (run by the main loop):
+
+BENCH_CRYPT_MAIN   crypt_main of the selected cipher over TEXT_LIST, one block per call
+BENCH_ECB          every entry of the cipher registry (cipher.h) over a 3 KB buffer:
+                   key setup, ECB encryption and decryption cycles, printed as CSV
+BENCH_CTR          CTR mode (CTR.h) of every registry entry on one keystream buffer of
+                   data: offline keystream generation, online XOR with the prefilled
+                   keystream, and encryption with on-demand keystream
+BENCH_CBC          CBC mode (CBC.h) of every registry entry over the 3 KB buffer:
+                   encryption and decryption cycles
+BENCH_GCM          GCM (GCM.h) of the registry entries with a 128 bits block over the
+                   3 KB buffer, table and constant-time GHASH: raw cipher (ECB), GHASH
+                   alone, tag generation (seal) and verification (open) cycles
+BENCH_CMAC         CMAC (CMAC.h) of every registry entry over the start of the flash,
+                   16 B to 4 KB messages: subkey derivation and MAC cycles
+BENCH_XTS          XTS (XTS.h) of the registry entries with a 128 bits block on 512 B
+                   and 4 KB sectors: cycles per sector and sectors per second
+BENCH_STREAM       streaming ECB (stream.h) of every registry entry over the 3 KB
+                   buffer as bytes, in one update and in RX_BUFFER_SIZE byte updates
+BENCH_BYTES        ECB of every registry entry over the 3 KB buffer through the word
+                   API and the byte API (aligned and unaligned buffers), and the cost
+                   of the byte order conversion alone
+BENCH_INPLACE      ECB of every registry entry over the 3 KB buffer with separate
+                   buffers and in place (out == in), word and byte API; the check
+                   covers in place calls of every block, bulk and mode API
+BENCH_PLACEMENT    ECB of every registry entry over the 3 KB buffer with the memory
+                   its encryption runs from, for the PLACEMENT of the build (make
+                   placements builds the three)
+BENCH_CACHE        one block and the 3 KB buffer of every registry entry with the
+                   flash instruction and data caches flushed before the call (first
+                   call latency) and repeated right after (steady state)
+BENCH_CLOCK        ECB of every registry entry over the 3 KB buffer at 16, 24 and 48 MHz
+                   (MSI) and 80 MHz (PLL), each with its minimum flash latency, and at
+                   16 MHz with 4 wait states: cycles per byte and bytes per second
+BENCH_UART_DMA     encrypt-and-echo of data sent by the host (Scripts/uart_dma_stream.py)
+                   with UART reception and transmission by DMA, at 115200 to 921600
+                   baud: sustained bytes per second and per chunk latency
+BENCH_JOBS         crypto job queue (jobqueue.h) of every registry entry: jobs submitted
+                   by a timer interrupt at 1k to 64k jobs per second and run by PendSV,
+                   queueing and processing latency and completed jobs per second
+BENCH_LATENCY      ECB and CTR of every registry entry over a 16 KB buffer in resumable
+                   steps (chunked.h) of 1 to 256 blocks with interrupts masked: worst
+                   case latency of a timer interrupt and throughput overhead
+BENCH_RTOS         crypto service thread (service.c) of the CMSIS-RTOS2 build serving 1 to
+                   4 client threads, all bulk or one interactive: throughput and latency
+                   percentiles per priority class. Needs USE_CMSIS_RTOS2 (make RTOS_SRC=...)
+BENCH_RANDOM       key setup and one block encryption of every registry entry on the fixed
+                   KEY and TEXT_LIST, random plaintexts and random keys and plaintexts
+                   drawn from a seed of the RNG (replayable, BENCH_SEED in benchmark.h):
+                   cycle distributions per input class
+BENCH_REKEY        key agility of every registry entry: cycles per key setup and keys per
+                   second, break-even message length against the bulk encryption, and
+                   cycles per byte of 16 B, 64 B and 1 KB messages with one key each
+BENCH_STACK        peak stack (painting) of the key setup, encryption and decryption of
+                   every registry entry and of crypt_main, with the context bytes, the
+                   encryption cycles and the static RAM of the image
+*/
+#define BENCH_CRYPT_MAIN 0
+#define BENCH_ECB        1
+#define BENCH_CTR        2
+#define BENCH_CBC        3
+#define BENCH_GCM        4
+#define BENCH_CMAC       5
+#define BENCH_XTS        6
+#define BENCH_STREAM     7
+#define BENCH_BYTES      8
+#define BENCH_INPLACE    9
+#define BENCH_PLACEMENT  10
+#define BENCH_CACHE      11
+#define BENCH_CLOCK      12
+#define BENCH_UART_DMA   13
+#define BENCH_JOBS       14
+#define BENCH_LATENCY    15
+#define BENCH_RTOS       16
+#define BENCH_RANDOM     17
+#define BENCH_REKEY      18
+#define BENCH_STACK      19
+
+#ifndef BENCHMARK
+#define BENCHMARK BENCH_CRYPT_MAIN
+#endif
@@ -0,0 +1,60 @@
+/* jobqueue.h
+*
+ * Lock-free single-producer/single-consumer queue of block cipher jobs
+ * (cipher.h). An interrupt handler submits jobs, and a lower priority
+ * handler (PendSV, see main.c) runs them in order and calls their
+ * completion callback.
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "cipher.h"
+
+#define JOB_ENCRYPT 0
+#define JOB_DECRYPT 1
+
+// jobs queued at most, a power of 2
+#define JOBQ_SIZE 16
+
+typedef struct CryptoJob CryptoJob;
+
+struct CryptoJob
+{
+	const BlockCipher* cipher;
+	CipherContext* key;               // expanded with cipher->init by the caller
+	uint8_t direction;
+	const uint32_t* in;
+	uint32_t* out;                    // may be in
+	uint32_t nrBlocks;
+	void (*callback)(CryptoJob* job); // run by the consumer when done, may be NULL
+	void* user;
+
+	// queue clock at submission, start and end of the processing
+	uint32_t submitted;
+	uint32_t started;
+	uint32_t finished;
+};
+
+typedef struct
+{
+	CryptoJob* volatile jobs[JOBQ_SIZE];
+	volatile uint32_t head;           // advanced by the producer only
+	volatile uint32_t tail;           // advanced by the consumer only
+	uint32_t (*now)(void);            // clock of the timestamps, may be NULL
+	void (*kick)(void);               // wakes up the consumer, may be NULL
+} JobQueue;
+
+void JOBQ_init(JobQueue* queue, uint32_t (*now)(void), void (*kick)(void));
+
+// producer: queues the job and kicks the consumer. Returns 0, or -1 when
+// the queue is full. The job belongs to the queue until its callback runs
+int JOBQ_submit(JobQueue* queue, CryptoJob* job);
+
+// consumer: runs the queued jobs, including those submitted meanwhile,
+// and returns how many
+uint32_t JOBQ_process(JobQueue* queue);
+
+// jobs queued or running
+uint32_t JOBQ_pending(const JobQueue* queue);
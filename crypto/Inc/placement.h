@@ -0,0 +1,28 @@
+/* placement.h
+*
+ * Section attributes of the round functions and lookup tables of the
+ * ciphers, following PLACEMENT in config.h.
+ *
+ * SRAM1: .RamFunc/.RamTable, collected in .data by the linker script and
+ * copied from flash by the startup code with the initialized data.
+ * SRAM2: .sram2.text/.sram2.table, collected in .sram2 (32 KB at
+ * 0x10000000) and copied by the startup code the same way.
+ * Calls between flash and SRAM are out of BL range; the linker inserts
+ * the long branch veneers.
+ *
+ */
+
+#pragma once
+
+#include "config.h"
+
+#if PLACEMENT == PLACE_SRAM1
+	#define HOT_CODE  __attribute__((section(".RamFunc")))
+	#define HOT_TABLE __attribute__((section(".RamTable")))
+#elif PLACEMENT == PLACE_SRAM2
+	#define HOT_CODE  __attribute__((section(".sram2.text")))
+	#define HOT_TABLE __attribute__((section(".sram2.table")))
+#else
+	#define HOT_CODE
+	#define HOT_TABLE
+#endif
@@ -0,0 +1,66 @@
+/* simd.h
+*
+ * Packed-lane arithmetic used by the multi-block kernels, and byte order
+ * reversal used at the byte buffer boundary.
+ *
+ * On the Cortex-M4 these map to the DSP extension instructions
+ * (UADD16/USUB16 on two 16-bit lanes, UADD8/USUB8 on four 8-bit lanes) and
+ * to REV. Other targets get an equivalent plain C version so the kernels
+ * still build and give the same results.
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+
+#include "cmsis_compiler.h"
+
+#define UADD16(a, b) __UADD16((a), (b))
+#define USUB16(a, b) __USUB16((a), (b))
+#define UADD8(a, b)  __UADD8((a), (b))
+#define USUB8(a, b)  __USUB8((a), (b))
+
+#else
+
+// add the two 16-bit lanes independently, carries do not cross lanes
+static inline uint32_t UADD16(uint32_t a, uint32_t b)
+{
+	return ((a & 0xffff0000) + (b & 0xffff0000)) | ((a + b) & 0x0000ffff);
+}
+
+static inline uint32_t USUB16(uint32_t a, uint32_t b)
+{
+	return ((a & 0xffff0000) - (b & 0xffff0000)) | ((a - b) & 0x0000ffff);
+}
+
+// add the four 8-bit lanes independently, carries do not cross lanes
+static inline uint32_t UADD8(uint32_t a, uint32_t b)
+{
+	return (((a & 0x7f7f7f7f) + (b & 0x7f7f7f7f)) ^ ((a ^ b) & 0x80808080));
+}
+
+static inline uint32_t USUB8(uint32_t a, uint32_t b)
+{
+	return (((a | 0x80808080) - (b & 0x7f7f7f7f)) ^ ((a ^ ~b) & 0x80808080));
+}
+
+#endif
+
+#if defined(__ARM_ARCH) && (__ARM_ARCH >= 6)
+
+#include "cmsis_compiler.h"
+
+#define REV(x) __REV(x)
+
+#else
+
+// reverse the bytes of the word
+static inline uint32_t REV(uint32_t x)
+{
+	return x >> 24 | (x >> 8 & 0x0000ff00) | (x << 8 & 0x00ff0000) | x << 24;
+}
+
+#endif
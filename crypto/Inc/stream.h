@@ -0,0 +1,35 @@
+/* stream.h
+*
+ * Streaming ECB encryption and decryption of byte strings of any length
+ * over the block cipher interface (cipher.h), PKCS#7 padded.
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "cipher.h"
+
+#define STREAM_ENCRYPT 0
+#define STREAM_DECRYPT 1
+
+typedef struct
+{
+	const BlockCipher* cipher;
+	CipherContext* key;                  // expanded with cipher->init by the caller
+	uint8_t direction;
+	uint8_t buffer[4 * MAX_BLOCK_WORDS]; // partial block
+	uint8_t bufferLen;
+} StreamContext;
+
+void STREAM_init(StreamContext* context, const BlockCipher* cipher, CipherContext* key, uint8_t direction);
+
+// processes the whole blocks available, returns the bytes written to out
+// (at most len + one block). In place, out trails in by the bytes held in
+// the context (out == in when none are): a buffer is processed in place in
+// pieces by advancing in and out by the bytes consumed and written
+uint32_t STREAM_update(StreamContext* context, const uint8_t* in, uint32_t len, uint8_t* out);
+
+// encrypt: pads and writes the last block; decrypt: writes the last block
+// without padding. Returns the bytes written, -1 on invalid padding
+int32_t STREAM_final(StreamContext* context, uint8_t* out);
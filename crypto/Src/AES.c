@@ -11,6 +11,10 @@
 //~ #include "common.h"
 #include "AES.h"
 #include "config.h"
+#include "cipher.h"
+#include "placement.h"
+#include "simd.h"
+#include <string.h>
 
 #ifdef USE_AES
 //-----------------------------------------------------------------------------
@@ -19,23 +23,15 @@
 // The number of columns comprising a state in AES. This is a constant in AES. Value=4
 #define Nb 4
 
-static uint8_t Nk;      // The number of 32 bit words in a key
-static uint8_t KEYLEN;  // Key length in bytes
-static uint8_t Nr;      // The number of rounds in AES Cipher
-
 // state - array holding the intermediate results during decryption.
-static uint8_t state[4][4];
-
-// The array that stores the round keys.
-static uint8_t RoundKey[240];
-
-// The Key input to the AES Program
-static const uint32_t* Key;
+// There is no global state: the state and the round keys are passed to
+// the round functions, so contexts may be used from several threads.
+typedef uint8_t state_t[4][4];
 
 // The lookup-tables are marked const so they can be placed in read-only storage instead of RAM
 // The numbers below can be computed dynamically trading ROM for RAM - 
 // This can be useful in (embedded) bootloader applications, where ROM is often limited.
-static const uint8_t sbox[256] = {
+HOT_TABLE static const uint8_t sbox[256] = {
   //0     1    2      3     4    5     6     7      8    9     A      B    C     D     E     F
   0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76,
   0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0,
@@ -54,7 +50,7 @@ static const uint8_t sbox[256] = {
   0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
   0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16 };
 
-static const uint8_t rsbox[256] = {
+HOT_TABLE static const uint8_t rsbox[256] = {
   0x52, 0x09, 0x6a, 0xd5, 0x30, 0x36, 0xa5, 0x38, 0xbf, 0x40, 0xa3, 0x9e, 0x81, 0xf3, 0xd7, 0xfb,
   0x7c, 0xe3, 0x39, 0x82, 0x9b, 0x2f, 0xff, 0x87, 0x34, 0x8e, 0x43, 0x44, 0xc4, 0xde, 0xe9, 0xcb,
   0x54, 0x7b, 0x94, 0x32, 0xa6, 0xc2, 0x23, 0x3d, 0xee, 0x4c, 0x95, 0x0b, 0x42, 0xfa, 0xc3, 0x4e,
@@ -92,19 +88,19 @@ static const uint8_t Rcon[256] = {
     0xc6, 0x97, 0x35, 0x6a, 0xd4, 0xb3, 0x7d, 0xfa, 0xef, 0xc5, 0x91, 0x39, 0x72, 0xe4, 0xd3, 0xbd,
     0x61, 0xc2, 0x9f, 0x25, 0x4a, 0x94, 0x33, 0x66, 0xcc, 0x83, 0x1d, 0x3a, 0x74, 0xe8, 0xcb, 0x8d };
 
-static uint8_t
+HOT_CODE static uint8_t
 getSBoxValue(uint8_t num) {
     return sbox[num];
 }
 
-static uint8_t
+HOT_CODE static uint8_t
 getSBoxInvert(uint8_t num) {
     return rsbox[num];
 }
 
 // This function produces Nb(Nr+1) round keys. The round keys are used in each round to decrypt the states. 
 static void
-KeyExpansion(void) {
+KeyExpansion(uint8_t* RoundKey, const uint32_t* Key, uint8_t Nk, uint8_t Nr) {
     uint32_t i, k;
     uint8_t tempa[4]; // Used for the column/row operations
 
@@ -165,24 +161,24 @@ KeyExpansion(void) {
 
 // This function adds the round key to state.
 // The round key is added to the state by an XOR function.
-static void
-AddRoundKey(uint8_t round) {
+HOT_CODE static void
+AddRoundKey(uint8_t round, state_t* state, const uint8_t* RoundKey) {
     uint8_t i, j;
     for(i = 0; i < 4; ++i) {
         for(j = 0; j < 4; ++j) {
-            state[i][j] ^= RoundKey[round * Nb * 4 + i * Nb + j];
+            (*state)[i][j] ^= RoundKey[round * Nb * 4 + i * Nb + j];
         }
     }
 }
 
 // The SubBytes Function Substitutes the values in the
 // state matrix with values in an S-box.
-static void
-SubBytes(void) {
+HOT_CODE static void
+SubBytes(state_t* state) {
     uint8_t i, j;
     for(i = 0; i < 4; ++i) {
         for(j = 0; j < 4; ++j) {
-            state[j][i] = getSBoxValue(state[j][i]);
+            (*state)[j][i] = getSBoxValue((*state)[j][i]);
         }
     }
 }
@@ -190,56 +186,56 @@ SubBytes(void) {
 // The ShiftRows() function shifts the rows in the state to the left.
 // Each row is shifted with different offset.
 // Offset = Row number. So the first row is not shifted.
-static void
-ShiftRows(void) {
+HOT_CODE static void
+ShiftRows(state_t* state) {
     uint8_t temp;
 
     // Rotate first row 1 columns to left  
-    temp        = state[0][1];
-    state[0][1] = state[1][1];
-    state[1][1] = state[2][1];
-    state[2][1] = state[3][1];
-    state[3][1] = temp;
+    temp        = (*state)[0][1];
+    (*state)[0][1] = (*state)[1][1];
+    (*state)[1][1] = (*state)[2][1];
+    (*state)[2][1] = (*state)[3][1];
+    (*state)[3][1] = temp;
 
     // Rotate second row 2 columns to left  
-    temp        = state[0][2];
-    state[0][2] = state[2][2];
-    state[2][2] = temp;
+    temp        = (*state)[0][2];
+    (*state)[0][2] = (*state)[2][2];
+    (*state)[2][2] = temp;
 
-    temp        = state[1][2];
-    state[1][2] = state[3][2];
-    state[3][2] = temp;
+    temp        = (*state)[1][2];
+    (*state)[1][2] = (*state)[3][2];
+    (*state)[3][2] = temp;
 
     // Rotate third row 3 columns to left
-    temp        = state[0][3];
-    state[0][3] = state[3][3];
-    state[3][3] = state[2][3];
-    state[2][3] = state[1][3];
-    state[1][3] = temp;
+    temp        = (*state)[0][3];
+    (*state)[0][3] = (*state)[3][3];
+    (*state)[3][3] = (*state)[2][3];
+    (*state)[2][3] = (*state)[1][3];
+    (*state)[1][3] = temp;
 }
 
-static uint8_t
+HOT_CODE static uint8_t
 xtime(uint8_t x) {
     return ((x<<1) ^ (((x>>7) & 1) * 0x1b));
 }
 
 // MixColumns function mixes the columns of the state matrix
-static void
-MixColumns(void) {
+HOT_CODE static void
+MixColumns(state_t* state) {
     uint8_t i;
     uint8_t Tmp, Tm, t;
     for(i = 0; i < 4; ++i) {  
-        t   = state[i][0];
-        Tmp = state[i][0] ^ state[i][1] ^ state[i][2] ^ state[i][3] ;
-        Tm  = state[i][0] ^ state[i][1] ; Tm = xtime(Tm);  state[i][0] ^= Tm ^ Tmp ;
-        Tm  = state[i][1] ^ state[i][2] ; Tm = xtime(Tm);  state[i][1] ^= Tm ^ Tmp ;
-        Tm  = state[i][2] ^ state[i][3] ; Tm = xtime(Tm);  state[i][2] ^= Tm ^ Tmp ;
-        Tm  = state[i][3] ^ t ;           Tm = xtime(Tm);  state[i][3] ^= Tm ^ Tmp ;
+        t   = (*state)[i][0];
+        Tmp = (*state)[i][0] ^ (*state)[i][1] ^ (*state)[i][2] ^ (*state)[i][3] ;
+        Tm  = (*state)[i][0] ^ (*state)[i][1] ; Tm = xtime(Tm);  (*state)[i][0] ^= Tm ^ Tmp ;
+        Tm  = (*state)[i][1] ^ (*state)[i][2] ; Tm = xtime(Tm);  (*state)[i][1] ^= Tm ^ Tmp ;
+        Tm  = (*state)[i][2] ^ (*state)[i][3] ; Tm = xtime(Tm);  (*state)[i][2] ^= Tm ^ Tmp ;
+        Tm  = (*state)[i][3] ^ t ;           Tm = xtime(Tm);  (*state)[i][3] ^= Tm ^ Tmp ;
     }
 }
 
 // Multiply is used to multiply numbers in the field GF(2^8)
-static uint8_t
+HOT_CODE static uint8_t
 Multiply(uint8_t x, uint8_t y) {
     return (((y & 1) * x) ^
          ((y>>1 & 1) * xtime(x)) ^
@@ -251,115 +247,117 @@ Multiply(uint8_t x, uint8_t y) {
 // MixColumns function mixes the columns of the state matrix.
 // The method used to multiply may be difficult to understand for the inexperienced.
 // Please use the references to gain more information.
-static void
-InvMixColumns(void) {
+HOT_CODE static void
+InvMixColumns(state_t* state) {
     int i;
     uint8_t a, b, c, d;
     for(i = 0; i < 4; ++i) { 
-        a = state[i][0];
-        b = state[i][1];
-        c = state[i][2];
-        d = state[i][3];
-
-        state[i][0] = Multiply(a, 0x0e) ^ Multiply(b, 0x0b) ^ Multiply(c, 0x0d) ^ Multiply(d, 0x09);
-        state[i][1] = Multiply(a, 0x09) ^ Multiply(b, 0x0e) ^ Multiply(c, 0x0b) ^ Multiply(d, 0x0d);
-        state[i][2] = Multiply(a, 0x0d) ^ Multiply(b, 0x09) ^ Multiply(c, 0x0e) ^ Multiply(d, 0x0b);
-        state[i][3] = Multiply(a, 0x0b) ^ Multiply(b, 0x0d) ^ Multiply(c, 0x09) ^ Multiply(d, 0x0e);
+        a = (*state)[i][0];
+        b = (*state)[i][1];
+        c = (*state)[i][2];
+        d = (*state)[i][3];
+
+        (*state)[i][0] = Multiply(a, 0x0e) ^ Multiply(b, 0x0b) ^ Multiply(c, 0x0d) ^ Multiply(d, 0x09);
+        (*state)[i][1] = Multiply(a, 0x09) ^ Multiply(b, 0x0e) ^ Multiply(c, 0x0b) ^ Multiply(d, 0x0d);
+        (*state)[i][2] = Multiply(a, 0x0d) ^ Multiply(b, 0x09) ^ Multiply(c, 0x0e) ^ Multiply(d, 0x0b);
+        (*state)[i][3] = Multiply(a, 0x0b) ^ Multiply(b, 0x0d) ^ Multiply(c, 0x09) ^ Multiply(d, 0x0e);
     }
 }
 
 // The SubBytes Function Substitutes the values in the
 // state matrix with values in an S-box.
-static void
-InvSubBytes(void) {
+HOT_CODE static void
+InvSubBytes(state_t* state) {
     uint8_t i, j;
     for(i = 0; i < 4; ++i) {
         for(j = 0; j < 4; ++j) {
-            state[j][i] = getSBoxInvert(state[j][i]);
+            (*state)[j][i] = getSBoxInvert((*state)[j][i]);
         }
     }
 }
 
-static void
-InvShiftRows(void) {
+HOT_CODE static void
+InvShiftRows(state_t* state) {
     uint8_t temp;
 
     // Rotate first row 1 columns to right  
-    temp = state[3][1];
-    state[3][1] = state[2][1];
-    state[2][1] = state[1][1];
-    state[1][1] = state[0][1];
-    state[0][1] = temp;
+    temp = (*state)[3][1];
+    (*state)[3][1] = (*state)[2][1];
+    (*state)[2][1] = (*state)[1][1];
+    (*state)[1][1] = (*state)[0][1];
+    (*state)[0][1] = temp;
 
     // Rotate second row 2 columns to right 
-    temp = state[0][2];
-    state[0][2] = state[2][2];
-    state[2][2] = temp;
+    temp = (*state)[0][2];
+    (*state)[0][2] = (*state)[2][2];
+    (*state)[2][2] = temp;
 
-    temp = state[1][2];
-    state[1][2] = state[3][2];
-    state[3][2] = temp;
+    temp = (*state)[1][2];
+    (*state)[1][2] = (*state)[3][2];
+    (*state)[3][2] = temp;
 
     // Rotate third row 3 columns to right
-    temp = state[0][3];
-    state[0][3] = state[1][3];
-    state[1][3] = state[2][3];
-    state[2][3] = state[3][3];
-    state[3][3] = temp;
+    temp = (*state)[0][3];
+    (*state)[0][3] = (*state)[1][3];
+    (*state)[1][3] = (*state)[2][3];
+    (*state)[2][3] = (*state)[3][3];
+    (*state)[3][3] = temp;
 }
 
 // Cipher is the main function that encrypts the PlainText.
-static void
-Cipher(void) {
+HOT_CODE static void
+Cipher(state_t* state, const uint8_t* RoundKey, uint8_t Nr) {
     uint8_t round = 0;
 
     // Add the First round key to the state before starting the rounds.
-    AddRoundKey(0); 
+    AddRoundKey(0, state, RoundKey); 
 
     // There will be Nr rounds.
     // The first Nr-1 rounds are identical.
     // These Nr-1 rounds are executed in the loop below.
     for(round = 1; round < Nr; ++round) {
-        SubBytes();
-        ShiftRows();
-        MixColumns();
-        AddRoundKey(round);
+        SubBytes(state);
+        ShiftRows(state);
+        MixColumns(state);
+        AddRoundKey(round, state, RoundKey);
     }
 
     // The last round is given below.
     // The MixColumns function is not here in the last round.
-    SubBytes();
-    ShiftRows();
-    AddRoundKey(Nr);
+    SubBytes(state);
+    ShiftRows(state);
+    AddRoundKey(Nr, state, RoundKey);
 }
 
-static void
-InvCipher(void) {
+HOT_CODE static void
+InvCipher(state_t* state, const uint8_t* RoundKey, uint8_t Nr) {
     uint8_t round = 0;
 
     // Add the First round key to the state before starting the rounds.
-    AddRoundKey(Nr); 
+    AddRoundKey(Nr, state, RoundKey); 
 
     // There will be Nr rounds.
     // The first Nr-1 rounds are identical.
     // These Nr-1 rounds are executed in the loop below.
     for(round = Nr-1; round > 0; round--) {
-        InvShiftRows();
-        InvSubBytes();
-        AddRoundKey(round);
-        InvMixColumns();
+        InvShiftRows(state);
+        InvSubBytes(state);
+        AddRoundKey(round, state, RoundKey);
+        InvMixColumns(state);
     }
 
     // The last round is given below.
     // The MixColumns function is not here in the last round.
-    InvShiftRows();
-    InvSubBytes();
-    AddRoundKey(0);
+    InvShiftRows(state);
+    InvSubBytes(state);
+    AddRoundKey(0, state, RoundKey);
 }
 
 void
 aes_ecb(uint32_t* key, uint32_t* input, uint32_t* output, uint8_t* crypt_config) {
-    uint8_t i;
+    uint8_t i, Nk, Nr;
+    state_t state;
+    uint8_t RoundKey[240];
 
     // Copy input to state
     for(i = 0; i < 4; i++) {
@@ -371,20 +369,19 @@ aes_ecb(uint32_t* key, uint32_t* input, uint32_t* output, uint8_t* crypt_config)
 
     // Update some private variables
     switch (crypt_config[2]) {
-        case 2  : Nk = 8; KEYLEN = 32; Nr = 14; break; // 256 bits
-        case 1  : Nk = 6; KEYLEN = 24; Nr = 12; break; // 192 bits
-        default : Nk = 4; KEYLEN = 16; Nr = 10; break; // 128 bits
+        case 2  : Nk = 8; Nr = 14; break; // 256 bits
+        case 1  : Nk = 6; Nr = 12; break; // 192 bits
+        default : Nk = 4; Nr = 10; break; // 128 bits
     }
 
     // The KeyExpansion routine must be called before encryption
-    Key = key;
-    KeyExpansion();
+    KeyExpansion(RoundKey, key, Nk, Nr);
 
     // The next function call encrypts the PlainText with the Key using AES algorithm
     if (crypt_config[0])
-        Cipher();
+        Cipher(&state, RoundKey, Nr);
     else
-        InvCipher();
+        InvCipher(&state, RoundKey, Nr);
 
     // Copy state to output
     for(i = 0; i < 4; i++) {
@@ -392,6 +389,89 @@ aes_ecb(uint32_t* key, uint32_t* input, uint32_t* output, uint8_t* crypt_config)
     }
 }
 
+HOT_CODE static void
+loadState(state_t* state, const uint32_t* input) {
+    uint32_t w;
+    uint8_t i;
+
+    // one REV per column instead of four shifts and masks
+    for(i = 0; i < 4; i++) {
+        w = REV(input[i]);
+        memcpy((*state)[i], &w, 4);
+    }
+}
+
+HOT_CODE static void
+storeState(const state_t* state, uint32_t* output) {
+    uint32_t w;
+    uint8_t i;
+
+    for(i = 0; i < 4; i++) {
+        memcpy(&w, (*state)[i], 4);
+        output[i] = REV(w);
+    }
+}
+
+// Expand the key once; blocks are then processed without re-keying
+void
+AES_init(AesContext* context, const uint32_t* key, uint16_t keyLen) {
+    switch (keyLen) {
+        case 256 : context->Nk = 8; context->Nr = 14; break;
+        case 192 : context->Nk = 6; context->Nr = 12; break;
+        default  : context->Nk = 4; context->Nr = 10; break;
+    }
+
+    KeyExpansion(context->roundKey, key, context->Nk, context->Nr);
+}
+
+HOT_CODE void
+AES_encrypt(AesContext* context, const uint32_t* input, uint32_t* output) {
+    state_t state;
+
+    loadState(&state, input);
+    Cipher(&state, context->roundKey, context->Nr);
+    storeState(&state, output);
+}
+
+HOT_CODE void
+AES_decrypt(AesContext* context, const uint32_t* input, uint32_t* output) {
+    state_t state;
+
+    loadState(&state, input);
+    InvCipher(&state, context->roundKey, context->Nr);
+    storeState(&state, output);
+}
+
+//-----------------------------------------------------------------------------
+// Block cipher interface (cipher.h)
+//-----------------------------------------------------------------------------
+static void
+aesInit(CipherContext* context, const uint32_t* key, uint16_t keyLen) {
+    AES_init(&context->aes, key, keyLen);
+}
+
+HOT_CODE static void
+aesEncrypt(CipherContext* context, const uint32_t* in, uint32_t* out, uint32_t nrBlocks) {
+    for(; nrBlocks > 0; nrBlocks--) {
+        AES_encrypt(&context->aes, in, out);
+        in += 4;
+        out += 4;
+    }
+}
+
+HOT_CODE static void
+aesDecrypt(CipherContext* context, const uint32_t* in, uint32_t* out, uint32_t nrBlocks) {
+    for(; nrBlocks > 0; nrBlocks--) {
+        AES_decrypt(&context->aes, in, out);
+        in += 4;
+        out += 4;
+    }
+}
+
+const BlockCipher AES_128_CIPHER = { "AES-128", 4, 128, aesInit, aesEncrypt, aesDecrypt, sizeof(AesContext) };
+const BlockCipher AES_192_CIPHER = { "AES-192", 4, 192, aesInit, aesEncrypt, aesDecrypt, sizeof(AesContext) };
+const BlockCipher AES_256_CIPHER = { "AES-256", 4, 256, aesInit, aesEncrypt, aesDecrypt, sizeof(AesContext) };
+
 //-----------------------------------------------------------------------------
 // Main Functions
 //-----------------------------------------------------------------------------
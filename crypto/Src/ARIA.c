@@ -17,6 +17,8 @@
 
 #include "ARIA.h"
 #include "config.h"
+#include "cipher.h"
+#include "placement.h"
 #ifdef USE_ARIA
 // constants
 const uint32_t C1[4] = { 0x517cc1b7, 0x27220a94, 0xfe13abe8, 0xfa9a6ee0 };
@@ -24,7 +26,7 @@ const uint32_t C2[4] = { 0x6db14acc, 0x9e21c820, 0xff28b1d5, 0xef5de2b0 };
 const uint32_t C3[4] = { 0xdb92371d, 0x2126e970, 0x03249775, 0x04e8c90e };
 
 // S-Boxes
-const uint8_t SB1[256] = {
+HOT_TABLE const uint8_t SB1[256] = {
 								0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76,
 								0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0,
 								0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
@@ -43,7 +45,7 @@ const uint8_t SB1[256] = {
 								0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16
 };
 
-const uint8_t SB2[256] = {
+HOT_TABLE const uint8_t SB2[256] = {
 								0xe2, 0x4e, 0x54, 0xfc, 0x94, 0xc2, 0x4a, 0xcc, 0x62, 0x0d, 0x6a, 0x46, 0x3c, 0x4d, 0x8b, 0xd1,
 								0x5e, 0xfa, 0x64, 0xcb, 0xb4, 0x97, 0xbe, 0x2b, 0xbc, 0x77, 0x2e, 0x03, 0xd3, 0x19, 0x59, 0xc1,
 								0x1d, 0x06, 0x41, 0x6b, 0x55, 0xf0, 0x99, 0x69, 0xea, 0x9c, 0x18, 0xae, 0x63, 0xdf, 0xe7, 0xbb,
@@ -62,7 +64,7 @@ const uint8_t SB2[256] = {
 								0xed, 0x14, 0xe0, 0xa5, 0x3d, 0x22, 0xb3, 0xf8, 0x89, 0xde, 0x71, 0x1a, 0xaf, 0xba, 0xb5, 0x81
 };
 
-const uint8_t SB3[256] = {
+HOT_TABLE const uint8_t SB3[256] = {
 								0x52, 0x09, 0x6a, 0xd5, 0x30, 0x36, 0xa5, 0x38, 0xbf, 0x40, 0xa3, 0x9e, 0x81, 0xf3, 0xd7, 0xfb,
 								0x7c, 0xe3, 0x39, 0x82, 0x9b, 0x2f, 0xff, 0x87, 0x34, 0x8e, 0x43, 0x44, 0xc4, 0xde, 0xe9, 0xcb,
 								0x54, 0x7b, 0x94, 0x32, 0xa6, 0xc2, 0x23, 0x3d, 0xee, 0x4c, 0x95, 0x0b, 0x42, 0xfa, 0xc3, 0x4e,
@@ -81,7 +83,7 @@ const uint8_t SB3[256] = {
 								0x17, 0x2b, 0x04, 0x7e, 0xba, 0x77, 0xd6, 0x26, 0xe1, 0x69, 0x14, 0x63, 0x55, 0x21, 0x0c, 0x7d
 };
 
-const uint8_t SB4[256] = {
+HOT_TABLE const uint8_t SB4[256] = {
 								0x30, 0x68, 0x99, 0x1b, 0x87, 0xb9, 0x21, 0x78, 0x50, 0x39, 0xdb, 0xe1, 0x72, 0x09, 0x62, 0x3c,
 								0x3e, 0x7e, 0x5e, 0x8e, 0xf1, 0xa0, 0xcc, 0xa3, 0x2a, 0x1d, 0xfb, 0xb6, 0xd6, 0x20, 0xc4, 0x8d,
 								0x81, 0x65, 0xf5, 0x89, 0xcb, 0x9d, 0x77, 0xc6, 0x57, 0x43, 0x56, 0x17, 0xd4, 0x40, 0x1a, 0x4d,
@@ -100,7 +102,7 @@ const uint8_t SB4[256] = {
 								0x25, 0x8a, 0xb5, 0xe7, 0x42, 0xb3, 0xc7, 0xea, 0xf7, 0x4c, 0x11, 0x33, 0x03, 0xa2, 0xac, 0x60
 };
 
-static void XOR_128(uint32_t* y, uint32_t* x)
+HOT_CODE static void XOR_128(uint32_t* y, uint32_t* x)
 {
 	y[0] ^= x[0];
 	y[1] ^= x[1];
@@ -108,7 +110,7 @@ static void XOR_128(uint32_t* y, uint32_t* x)
 	y[3] ^= x[3];
 }
 
-static void MOV_128(uint32_t* y, const uint32_t* x)
+HOT_CODE static void MOV_128(uint32_t* y, const uint32_t* x)
 {
 	y[0] = x[0];
 	y[1] = x[1];
@@ -134,7 +136,7 @@ static void ROR_128(uint32_t* y, uint32_t* x, uint32_t n)
 	y[0] = (x[0] >> n) | (x[3] << (32 - n));
 }
 
-static void SL1(uint32_t* input, uint32_t* output)
+HOT_CODE static void SL1(uint32_t* input, uint32_t* output)
 {
 	/*
 		y0 = SB1(x0),  y1 = SB2(x1),  y2 = SB3(x2),  y3 = SB4(x3),
@@ -164,7 +166,7 @@ static void SL1(uint32_t* input, uint32_t* output)
 		| SB4[(uint8_t)(input[3] >> 0)];
 }
 
-static void SL2(uint32_t* input, uint32_t* output)
+HOT_CODE static void SL2(uint32_t* input, uint32_t* output)
 {
 	/*
 		y0 = SB3(x0),  y1 = SB4(x1),  y2 = SB1(x2),  y3 = SB2(x3),
@@ -194,7 +196,7 @@ static void SL2(uint32_t* input, uint32_t* output)
 		| SB2[(uint8_t)(input[3] >> 0)];
 }
 
-static void A(uint32_t* input, uint32_t* output)
+HOT_CODE static void A(uint32_t* input, uint32_t* output)
 {
 	/*
 		y0  = x3 ^ x4 ^ x6 ^ x8  ^ x9  ^ x13 ^ x14,
@@ -255,7 +257,7 @@ static void A(uint32_t* input, uint32_t* output)
 	output[3] = y12 << 24 | y13 << 16 | y14 << 8 | y15;
 }
 
-static void FO(uint32_t* D, uint32_t* RK, uint32_t* output)
+HOT_CODE static void FO(uint32_t* D, uint32_t* RK, uint32_t* output)
 {
 	// A(SL1(D ^ RK))
 	uint32_t y[4];
@@ -271,7 +273,7 @@ static void FO(uint32_t* D, uint32_t* RK, uint32_t* output)
 	A(y, output);
 }
 
-static void FE(uint32_t* D, uint32_t* RK, uint32_t* output)
+HOT_CODE static void FE(uint32_t* D, uint32_t* RK, uint32_t* output)
 {
 	// A(SL2(D ^ RK))
 	uint32_t y[4];
@@ -455,7 +457,7 @@ void ARIA_init(AriaContext* context, const uint32_t* key, uint32_t keyLength)
 	generateDecryptionKeys(context->eks, context->dks, context->rounds);
 }
 
-void ARIA_encrypt(AriaContext* context, uint32_t* block, uint32_t* P)
+HOT_CODE void ARIA_encrypt(AriaContext* context, uint32_t* block, uint32_t* P)
 {
 	uint32_t round = 0;
 	uint32_t subkey = 0;
@@ -488,7 +490,7 @@ void ARIA_encrypt(AriaContext* context, uint32_t* block, uint32_t* P)
 	XOR_128(P, context->eks[subkey++]);
 }
 
-void ARIA_decrypt(AriaContext* context, uint32_t* block, uint32_t* P)
+HOT_CODE void ARIA_decrypt(AriaContext* context, uint32_t* block, uint32_t* P)
 {
 	uint32_t round = 0;
 	uint32_t subkey = 0;
@@ -520,6 +522,36 @@ void ARIA_decrypt(AriaContext* context, uint32_t* block, uint32_t* P)
 	XOR_128(P, context->dks[subkey++]);
 }
 
+// Block cipher interface (cipher.h)
+static void ariaInit(CipherContext* context, const uint32_t* key, uint16_t keyLen)
+{
+	ARIA_init(&context->aria, key, keyLen);
+}
+
+HOT_CODE static void ariaEncrypt(CipherContext* context, const uint32_t* in, uint32_t* out, uint32_t nrBlocks)
+{
+	for (; nrBlocks > 0; nrBlocks--)
+	{
+		ARIA_encrypt(&context->aria, (uint32_t*)in, out);
+		in += 4;
+		out += 4;
+	}
+}
+
+HOT_CODE static void ariaDecrypt(CipherContext* context, const uint32_t* in, uint32_t* out, uint32_t nrBlocks)
+{
+	for (; nrBlocks > 0; nrBlocks--)
+	{
+		ARIA_decrypt(&context->aria, (uint32_t*)in, out);
+		in += 4;
+		out += 4;
+	}
+}
+
+const BlockCipher ARIA_128_CIPHER = { "ARIA-128", 4, 128, ariaInit, ariaEncrypt, ariaDecrypt, sizeof(AriaContext) };
+const BlockCipher ARIA_192_CIPHER = { "ARIA-192", 4, 192, ariaInit, ariaEncrypt, ariaDecrypt, sizeof(AriaContext) };
+const BlockCipher ARIA_256_CIPHER = { "ARIA-256", 4, 256, ariaInit, ariaEncrypt, ariaDecrypt, sizeof(AriaContext) };
+
 int crypt_main(uint32_t* text, uint32_t* key)
 {
 	AriaContext context;
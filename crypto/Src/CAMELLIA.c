@@ -18,6 +18,8 @@
 
 #include "CAMELLIA.h"
 #include "config.h"
+#include "cipher.h"
+#include "placement.h"
 
 #ifdef USE_CAMELLIA
 
@@ -31,7 +33,7 @@ static const uint64_t sigma[6] =
 	0xB05688C2B3E6C1FD  // sigma 6
 };
 
-static const uint8_t sbox1[256] =
+HOT_TABLE static const uint8_t sbox1[256] =
 {
 	0x70, 0x82, 0x2C, 0xEC, 0xB3, 0x27, 0xC0, 0xE5, 0xE4, 0x85, 0x57, 0x35, 0xEA, 0x0C, 0xAE, 0x41,
 	0x23, 0xEF, 0x6B, 0x93, 0x45, 0x19, 0xA5, 0x21, 0xED, 0x0E, 0x4F, 0x4E, 0x1D, 0x65, 0x92, 0xBD,
@@ -52,7 +54,7 @@ static const uint8_t sbox1[256] =
 };
 
 //Substitution table 2
-static const uint8_t sbox2[256] =
+HOT_TABLE static const uint8_t sbox2[256] =
 {
    0xE0, 0x05, 0x58, 0xD9, 0x67, 0x4E, 0x81, 0xCB, 0xC9, 0x0B, 0xAE, 0x6A, 0xD5, 0x18, 0x5D, 0x82,
    0x46, 0xDF, 0xD6, 0x27, 0x8A, 0x32, 0x4B, 0x42, 0xDB, 0x1C, 0x9E, 0x9C, 0x3A, 0xCA, 0x25, 0x7B,
@@ -73,7 +75,7 @@ static const uint8_t sbox2[256] =
 };
 
 //Substitution table 3
-static const uint8_t sbox3[256] =
+HOT_TABLE static const uint8_t sbox3[256] =
 {
    0x38, 0x41, 0x16, 0x76, 0xD9, 0x93, 0x60, 0xF2, 0x72, 0xC2, 0xAB, 0x9A, 0x75, 0x06, 0x57, 0xA0,
    0x91, 0xF7, 0xB5, 0xC9, 0xA2, 0x8C, 0xD2, 0x90, 0xF6, 0x07, 0xA7, 0x27, 0x8E, 0xB2, 0x49, 0xDE,
@@ -94,7 +96,7 @@ static const uint8_t sbox3[256] =
 };
 
 //Substitution table 4
-static const uint8_t sbox4[256] =
+HOT_TABLE static const uint8_t sbox4[256] =
 {
    0x70, 0x2C, 0xB3, 0xC0, 0xE4, 0x57, 0xEA, 0xAE, 0x23, 0x6B, 0x45, 0xA5, 0xED, 0x4F, 0x1D, 0x92,
    0x86, 0xAF, 0x7C, 0x1F, 0x3E, 0xDC, 0x5E, 0x0B, 0xA6, 0x39, 0xD5, 0x5D, 0xD9, 0x5A, 0x51, 0x6C,
@@ -115,7 +117,7 @@ static const uint8_t sbox4[256] =
 };
 
 // Rotate Left circular shift 32 bits
-static uint32_t ROL_32(uint32_t x, uint32_t n)
+HOT_CODE static uint32_t ROL_32(uint32_t x, uint32_t n)
 {
 	return x << n | x >> (32 - n);
 }
@@ -128,7 +130,7 @@ void ROL_128(uint64_t* y, uint64_t* x, uint32_t n)
 	y[1] = (x[1] << n) | (temp >> (64 - n));
 }
 
-uint64_t F(uint64_t F_IN, uint64_t KE)
+HOT_CODE uint64_t F(uint64_t F_IN, uint64_t KE)
 {
 	uint64_t x;
 	uint8_t t1, t2, t3, t4, t5, t6, t7, t8;
@@ -163,7 +165,7 @@ uint64_t F(uint64_t F_IN, uint64_t KE)
 		((uint64_t)y5 << 24) | ((uint64_t)y6 << 16) | ((uint64_t)y7 << 8) | y8;
 }
 
-uint64_t FL(uint64_t FL_IN, uint64_t KE)
+HOT_CODE uint64_t FL(uint64_t FL_IN, uint64_t KE)
 {
 	uint32_t x1, x2;
 	uint32_t k1, k2;
@@ -176,7 +178,7 @@ uint64_t FL(uint64_t FL_IN, uint64_t KE)
 	return ((uint64_t)x1 << 32) | x2;
 }
 
-uint64_t FLINV(uint64_t FLINV_IN, uint64_t KE)
+HOT_CODE uint64_t FLINV(uint64_t FLINV_IN, uint64_t KE)
 {
 	uint32_t y1, y2;
 	uint32_t k1, k2;
@@ -388,7 +390,7 @@ void CAMELLIA_init(CamelliaContext* context, const uint64_t* key, uint16_t keyLe
 	}
 }
 
-void CAMELLIA_encrypt(const CamelliaContext* context, const uint64_t* block, uint64_t* out)
+HOT_CODE void CAMELLIA_encrypt(const CamelliaContext* context, const uint64_t* block, uint64_t* out)
 {
 	// D[0] is D1 and D[1] is D2
 	uint64_t D[2] = { block[0], block[1] };
@@ -433,7 +435,7 @@ void CAMELLIA_encrypt(const CamelliaContext* context, const uint64_t* block, uin
 	out[1] = D[0];
 }
 
-void CAMELLIA_decrypt(const CamelliaContext* context, const uint64_t* block, uint64_t* out)
+HOT_CODE void CAMELLIA_decrypt(const CamelliaContext* context, const uint64_t* block, uint64_t* out)
 {
 	// D[0] is D1 and D[1] is D2
 	uint64_t D[2] = { block[0], block[1] };
@@ -480,6 +482,64 @@ void CAMELLIA_decrypt(const CamelliaContext* context, const uint64_t* block, uin
 	out[1] = D[0];
 }
 
+// Block cipher interface (cipher.h)
+static void camelliaInit(CipherContext* context, const uint32_t* key, uint16_t keyLen)
+{
+	uint64_t key_in[4];
+	int i;
+
+	for (i = 0; i < keyLen / 64; i++)
+	{
+		key_in[i] = (uint64_t)key[2 * i] << 32 | key[2 * i + 1];
+	}
+
+	CAMELLIA_init(&context->camellia, key_in, keyLen);
+}
+
+HOT_CODE static void camelliaEncrypt(CipherContext* context, const uint32_t* in, uint32_t* out, uint32_t nrBlocks)
+{
+	uint64_t block[2];
+
+	for (; nrBlocks > 0; nrBlocks--)
+	{
+		block[0] = (uint64_t)in[0] << 32 | in[1];
+		block[1] = (uint64_t)in[2] << 32 | in[3];
+
+		CAMELLIA_encrypt(&context->camellia, block, block);
+
+		out[0] = (uint32_t)(block[0] >> 32);
+		out[1] = (uint32_t)block[0];
+		out[2] = (uint32_t)(block[1] >> 32);
+		out[3] = (uint32_t)block[1];
+		in += 4;
+		out += 4;
+	}
+}
+
+HOT_CODE static void camelliaDecrypt(CipherContext* context, const uint32_t* in, uint32_t* out, uint32_t nrBlocks)
+{
+	uint64_t block[2];
+
+	for (; nrBlocks > 0; nrBlocks--)
+	{
+		block[0] = (uint64_t)in[0] << 32 | in[1];
+		block[1] = (uint64_t)in[2] << 32 | in[3];
+
+		CAMELLIA_decrypt(&context->camellia, block, block);
+
+		out[0] = (uint32_t)(block[0] >> 32);
+		out[1] = (uint32_t)block[0];
+		out[2] = (uint32_t)(block[1] >> 32);
+		out[3] = (uint32_t)block[1];
+		in += 4;
+		out += 4;
+	}
+}
+
+const BlockCipher CAMELLIA_128_CIPHER = { "CAMELLIA-128", 4, 128, camelliaInit, camelliaEncrypt, camelliaDecrypt, sizeof(CamelliaContext) };
+const BlockCipher CAMELLIA_192_CIPHER = { "CAMELLIA-192", 4, 192, camelliaInit, camelliaEncrypt, camelliaDecrypt, sizeof(CamelliaContext) };
+const BlockCipher CAMELLIA_256_CIPHER = { "CAMELLIA-256", 4, 256, camelliaInit, camelliaEncrypt, camelliaDecrypt, sizeof(CamelliaContext) };
+
 int crypt_main(uint32_t* text, uint32_t* key)
 {
 	CamelliaContext context;
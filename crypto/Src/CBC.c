@@ -0,0 +1,65 @@
+/* CBC.c
+*
+ * Cipher block chaining mode over the block cipher interface (cipher.h).
+ *
+ * Encryption is serial, one block per cipher call. Decryption of the
+ * blocks is independent, so CBC_decrypt hands CBC_DECRYPT_BLOCKS blocks at
+ * a time to the cipher, which lets the multi-block kernels (HIGHT-x4,
+ * IDEA-x2) work on a full group, and chains the results afterwards.
+ *
+ */
+
+#include <string.h>
+#include "CBC.h"
+
+void CBC_encrypt(const BlockCipher* cipher, CipherContext* key, uint32_t* iv, const uint32_t* in, uint32_t* out, uint32_t nrBlocks)
+{
+	uint8_t blockWords = cipher->blockWords;
+	uint32_t block[MAX_BLOCK_WORDS];
+	uint8_t i;
+
+	for (; nrBlocks > 0; nrBlocks--)
+	{
+		for (i = 0; i < blockWords; i++)
+		{
+			block[i] = in[i] ^ iv[i];
+		}
+
+		cipher->encrypt(key, block, out, 1);
+		memcpy(iv, out, blockWords * sizeof(uint32_t));
+
+		in += blockWords;
+		out += blockWords;
+	}
+}
+
+void CBC_decrypt(const BlockCipher* cipher, CipherContext* key, uint32_t* iv, const uint32_t* in, uint32_t* out, uint32_t nrBlocks)
+{
+	uint8_t blockWords = cipher->blockWords;
+	uint32_t plain[CBC_DECRYPT_BLOCKS * MAX_BLOCK_WORDS];
+	uint32_t nextIv[MAX_BLOCK_WORDS];
+	uint32_t n;
+	uint32_t i;
+
+	for (; nrBlocks > 0; nrBlocks -= n)
+	{
+		n = nrBlocks < CBC_DECRYPT_BLOCKS ? nrBlocks : CBC_DECRYPT_BLOCKS;
+
+		cipher->decrypt(key, in, plain, n);
+		memcpy(nextIv, in + (n - 1) * blockWords, blockWords * sizeof(uint32_t));
+
+		// chain from the last block down, so in place the previous ciphertext is still there
+		for (i = n * blockWords; i > blockWords; i--)
+		{
+			out[i - 1] = plain[i - 1] ^ in[i - 1 - blockWords];
+		}
+		for (i = 0; i < blockWords; i++)
+		{
+			out[i] = plain[i] ^ iv[i];
+		}
+
+		memcpy(iv, nextIv, blockWords * sizeof(uint32_t));
+		in += n * blockWords;
+		out += n * blockWords;
+	}
+}
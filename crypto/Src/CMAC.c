@@ -0,0 +1,134 @@
+/* CMAC.c
+*
+ * CMAC message authentication (NIST SP 800-38B) over the block cipher
+ * interface (cipher.h), for 64 and 128 bits blocks.
+ *
+ * Messages are byte strings; a block is loaded into the cipher words most
+ * significant byte first. Whole blocks are taken straight from the caller's
+ * data, only the last (possibly partial) block is copied into the context,
+ * since it is combined with a subkey in CMAC_final.
+ *
+ */
+
+#include <string.h>
+#include "CMAC.h"
+
+// x = E(x ^ block)
+static void chain(CmacContext* context, const uint8_t* block)
+{
+	uint32_t words[MAX_BLOCK_WORDS];
+	uint8_t i;
+
+	CIPHER_load_words(block, words, context->cipher->blockWords);
+	for (i = 0; i < context->cipher->blockWords; i++)
+	{
+		context->x[i] ^= words[i];
+	}
+
+	context->cipher->encrypt(context->key, context->x, context->x, 1);
+}
+
+// out = in << 1, reduced with Rb (0x87 for 128 bits blocks, 0x1b for 64 bits)
+static void doubleBlock(const uint32_t* in, uint32_t* out, uint8_t nrWords)
+{
+	uint32_t rb = (nrWords == 4) ? 0x87 : 0x1b;
+	uint32_t msb = in[0] >> 31;
+	uint8_t i;
+
+	for (i = 0; i < nrWords - 1; i++)
+	{
+		out[i] = in[i] << 1 | in[i + 1] >> 31;
+	}
+	out[nrWords - 1] = (in[nrWords - 1] << 1) ^ ((0 - msb) & rb);
+}
+
+void CMAC_init(CmacContext* context, const BlockCipher* cipher, CipherContext* key)
+{
+	uint32_t l[MAX_BLOCK_WORDS] = { 0 };
+
+	context->cipher = cipher;
+	context->key = key;
+
+	cipher->encrypt(key, l, l, 1);
+	doubleBlock(l, context->k1, cipher->blockWords);
+	doubleBlock(context->k1, context->k2, cipher->blockWords);
+
+	memset(context->x, 0, sizeof(context->x));
+	context->bufferLen = 0;
+}
+
+void CMAC_update(CmacContext* context, const uint8_t* data, uint32_t len)
+{
+	uint8_t blockBytes = 4 * context->cipher->blockWords;
+	uint32_t n;
+
+	if (len == 0)
+	{
+		return;
+	}
+
+	// complete the buffered block; it is chained only when more data follows
+	if (context->bufferLen > 0)
+	{
+		n = blockBytes - context->bufferLen;
+		if (n > len)
+		{
+			n = len;
+		}
+
+		memcpy(context->buffer + context->bufferLen, data, n);
+		context->bufferLen += n;
+		data += n;
+		len -= n;
+
+		if (len == 0)
+		{
+			return;
+		}
+
+		chain(context, context->buffer);
+		context->bufferLen = 0;
+	}
+
+	// whole blocks from the caller's data, keeping back the last one
+	while (len > blockBytes)
+	{
+		chain(context, data);
+		data += blockBytes;
+		len -= blockBytes;
+	}
+
+	memcpy(context->buffer, data, len);
+	context->bufferLen = len;
+}
+
+void CMAC_final(CmacContext* context, uint8_t* mac)
+{
+	uint8_t blockWords = context->cipher->blockWords;
+	uint8_t blockBytes = 4 * blockWords;
+	const uint32_t* subkey;
+	uint8_t i;
+
+	if (context->bufferLen == blockBytes)
+	{
+		subkey = context->k1;
+	}
+	else
+	{
+		// pad with 10...0
+		context->buffer[context->bufferLen] = 0x80;
+		memset(context->buffer + context->bufferLen + 1, 0, blockBytes - context->bufferLen - 1);
+		subkey = context->k2;
+	}
+
+	for (i = 0; i < blockWords; i++)
+	{
+		context->x[i] ^= subkey[i];
+	}
+	chain(context, context->buffer);
+
+	CIPHER_store_words(context->x, mac, blockWords);
+
+	memset(context->x, 0, sizeof(context->x));
+	context->bufferLen = 0;
+}
@@ -0,0 +1,105 @@
+/* CTR.c
+*
+ * Counter mode over the block cipher interface (cipher.h).
+ *
+ * The initial counter block is the nonce; the whole block is incremented
+ * as a big-endian number. Keystream is produced in bulk: counter blocks are
+ * written to the keystream buffer and encrypted in place with one call of
+ * the cipher, so CTR_prefill can move all the cipher work out of CTR_crypt.
+ *
+ */
+
+#include <string.h>
+#include "CTR.h"
+
+static void incrementCounter(uint32_t* counter, uint8_t blockWords)
+{
+	int i;
+
+	for (i = blockWords - 1; i >= 0; i--)
+	{
+		if (++counter[i] != 0)
+		{
+			break;
+		}
+	}
+}
+
+// append nrBlocks keystream blocks to the buffer
+static void generateKeystream(CtrContext* context, uint32_t nrBlocks)
+{
+	uint8_t blockWords = context->cipher->blockWords;
+	uint32_t* ks = context->keystream + context->available;
+	uint32_t i;
+
+	for (i = 0; i < nrBlocks; i++)
+	{
+		memcpy(ks + i * blockWords, context->counter, blockWords * sizeof(uint32_t));
+		incrementCounter(context->counter, blockWords);
+	}
+
+	context->cipher->encrypt(context->key, ks, ks, nrBlocks);
+	context->available += nrBlocks * blockWords;
+}
+
+void CTR_init(CtrContext* context, const BlockCipher* cipher, CipherContext* key, const uint32_t* nonce)
+{
+	context->cipher = cipher;
+	context->key = key;
+	memcpy(context->counter, nonce, cipher->blockWords * sizeof(uint32_t));
+	context->available = 0;
+	context->position = 0;
+}
+
+void CTR_prefill(CtrContext* context)
+{
+	uint32_t unused = context->available - context->position;
+
+	// keep the unused keystream at the start of the buffer
+	memmove(context->keystream, context->keystream + context->position, unused * sizeof(uint32_t));
+	context->available = unused;
+	context->position = 0;
+
+	generateKeystream(context, (CTR_KEYSTREAM_WORDS - unused) / context->cipher->blockWords);
+}
+
+void CTR_crypt(CtrContext* context, const uint32_t* in, uint32_t* out, uint32_t nrWords)
+{
+	uint8_t blockWords = context->cipher->blockWords;
+	uint32_t nrBlocks;
+	uint32_t n;
+	uint32_t i;
+
+	while (nrWords > 0)
+	{
+		if (context->position == context->available)
+		{
+			// buffer empty: generate only the blocks still needed
+			nrBlocks = (nrWords + blockWords - 1) / blockWords;
+			if (nrBlocks > CTR_KEYSTREAM_WORDS / blockWords)
+			{
+				nrBlocks = CTR_KEYSTREAM_WORDS / blockWords;
+			}
+
+			context->available = 0;
+			context->position = 0;
+			generateKeystream(context, nrBlocks);
+		}
+
+		n = context->available - context->position;
+		if (n > nrWords)
+		{
+			n = nrWords;
+		}
+
+		for (i = 0; i < n; i++)
+		{
+			out[i] = in[i] ^ context->keystream[context->position + i];
+		}
+
+		context->position += n;
+		in += n;
+		out += n;
+		nrWords -= n;
+	}
+}
@@ -0,0 +1,225 @@
+/* GCM.c
+*
+ * Galois/counter mode authenticated encryption over the block cipher
+ * interface (cipher.h), for the ciphers with a 128 bits block.
+ *
+ * This code follows a specification:
+ *		- NIST SP 800-38D
+ *
+ * GHASH multiplies by H four bits at a time with a 16 entries table of the
+ * multiples of H, computed once per key (Shoup's method), and a reduction
+ * table for the four bits shifted out. In constant-time mode every table
+ * entry is read and the wanted one selected with masks, and the reduction
+ * is computed from the bits, so no address depends on the key or the data.
+ * The encryption is CTR.c from the block after the pre-counter block.
+ *
+ */
+
+#include <string.h>
+#include "GCM.h"
+
+static const uint16_t LAST4[16] =
+{
+	0x0000, 0x1c20, 0x3840, 0x2460, 0x7080, 0x6ca0, 0x48c0, 0x54e0,
+	0xe100, 0xfd20, 0xd940, 0xc560, 0x9180, 0x8da0, 0xa9c0, 0xb5e0
+};
+
+// z = z >> 4, reduced
+static void shift4(uint32_t* z, uint8_t constantTime)
+{
+	uint32_t rem = z[3] & 0xf;
+	uint32_t r;
+
+	if (constantTime)
+	{
+		// LAST4 is linear in the bits of rem
+		r = (0 - (rem & 1)) & 0x1c20;
+		r ^= (0 - ((rem >> 1) & 1)) & 0x3840;
+		r ^= (0 - ((rem >> 2) & 1)) & 0x7080;
+		r ^= (0 - ((rem >> 3) & 1)) & 0xe100;
+	}
+	else
+	{
+		r = LAST4[rem];
+	}
+
+	z[3] = z[3] >> 4 | z[2] << 28;
+	z[2] = z[2] >> 4 | z[1] << 28;
+	z[1] = z[1] >> 4 | z[0] << 28;
+	z[0] = (z[0] >> 4) ^ (r << 16);
+}
+
+// z ^= table[index]
+static void addEntry(GcmContext* context, uint32_t* z, uint32_t index)
+{
+	uint32_t mask;
+	uint32_t i;
+
+	if (context->constantTime)
+	{
+		for (i = 0; i < 16; i++)
+		{
+			mask = 0 - (((i ^ index) - 1) >> 31);
+			z[0] ^= context->table[i][0] & mask;
+			z[1] ^= context->table[i][1] & mask;
+			z[2] ^= context->table[i][2] & mask;
+			z[3] ^= context->table[i][3] & mask;
+		}
+	}
+	else
+	{
+		z[0] ^= context->table[index][0];
+		z[1] ^= context->table[index][1];
+		z[2] ^= context->table[index][2];
+		z[3] ^= context->table[index][3];
+	}
+}
+
+// x = x * H
+static void multiplyH(GcmContext* context, uint32_t* x)
+{
+	uint32_t z[4] = { 0, 0, 0, 0 };
+	uint32_t byte;
+	int i;
+
+	// bytes from the last one, low nibble first
+	for (i = 15; i >= 0; i--)
+	{
+		byte = x[i / 4] >> (8 * (3 - i % 4));
+
+		if (i != 15)
+		{
+			shift4(z, context->constantTime);
+		}
+		addEntry(context, z, byte & 0xf);
+
+		shift4(z, context->constantTime);
+		addEntry(context, z, (byte >> 4) & 0xf);
+	}
+
+	x[0] = z[0];
+	x[1] = z[1];
+	x[2] = z[2];
+	x[3] = z[3];
+}
+
+void GCM_ghash(GcmContext* context, const uint32_t* data, uint32_t nrWords)
+{
+	uint32_t n;
+	uint32_t i;
+
+	for (; nrWords > 0; nrWords -= n)
+	{
+		n = nrWords < 4 ? nrWords : 4;
+
+		for (i = 0; i < n; i++)
+		{
+			context->y[i] ^= data[i];
+		}
+		multiplyH(context, context->y);
+
+		data += n;
+	}
+}
+
+void GCM_init(GcmContext* context, const BlockCipher* cipher, CipherContext* key, uint8_t constantTime)
+{
+	uint32_t* v;
+	uint32_t i;
+	uint32_t j;
+
+	context->cipher = cipher;
+	context->key = key;
+	context->constantTime = constantTime;
+
+	// table[8] = H, table[4] = H * x, table[2] = H * x^2, table[1] = H * x^3
+	memset(context->table, 0, sizeof(context->table));
+	cipher->encrypt(key, context->table[0], context->table[8], 1);
+
+	for (i = 4; i > 0; i >>= 1)
+	{
+		v = context->table[2 * i];
+		context->table[i][3] = v[3] >> 1 | v[2] << 31;
+		context->table[i][2] = v[2] >> 1 | v[1] << 31;
+		context->table[i][1] = v[1] >> 1 | v[0] << 31;
+		context->table[i][0] = (v[0] >> 1) ^ ((0 - (v[3] & 1)) & 0xe1000000);
+	}
+
+	// the other entries are sums of those four
+	for (i = 2; i <= 8; i *= 2)
+	{
+		for (j = 1; j < i; j++)
+		{
+			context->table[i + j][0] = context->table[i][0] ^ context->table[j][0];
+			context->table[i + j][1] = context->table[i][1] ^ context->table[j][1];
+			context->table[i + j][2] = context->table[i][2] ^ context->table[j][2];
+			context->table[i + j][3] = context->table[i][3] ^ context->table[j][3];
+		}
+	}
+}
+
+// J0 = IV || 1, counter from J0 + 1, GHASH of the AAD
+static void start(GcmContext* context, const uint32_t* iv, const uint32_t* aad, uint32_t aadWords)
+{
+	uint32_t counter[4];
+
+	context->j0[0] = iv[0];
+	context->j0[1] = iv[1];
+	context->j0[2] = iv[2];
+	context->j0[3] = 1;
+
+	memcpy(counter, context->j0, sizeof(counter));
+	counter[3] = 2;
+	CTR_init(&context->ctr, context->cipher, context->key, counter);
+
+	memset(context->y, 0, sizeof(context->y));
+	GCM_ghash(context, aad, aadWords);
+}
+
+// GHASH of the lengths in bits, tag = E(J0) ^ GHASH
+static void finish(GcmContext* context, uint32_t aadWords, uint32_t nrWords, uint32_t* tag)
+{
+	uint32_t lengths[4];
+	uint32_t i;
+
+	lengths[0] = aadWords >> 27;
+	lengths[1] = aadWords << 5;
+	lengths[2] = nrWords >> 27;
+	lengths[3] = nrWords << 5;
+	GCM_ghash(context, lengths, 4);
+
+	context->cipher->encrypt(context->key, context->j0, tag, 1);
+	for (i = 0; i < GCM_TAG_WORDS; i++)
+	{
+		tag[i] ^= context->y[i];
+	}
+}
+
+void GCM_encrypt(GcmContext* context, const uint32_t* iv, const uint32_t* aad, uint32_t aadWords,
+	const uint32_t* in, uint32_t* out, uint32_t nrWords, uint32_t* tag)
+{
+	start(context, iv, aad, aadWords);
+	CTR_crypt(&context->ctr, in, out, nrWords);
+	GCM_ghash(context, out, nrWords);
+	finish(context, aadWords, nrWords, tag);
+}
+
+int GCM_decrypt(GcmContext* context, const uint32_t* iv, const uint32_t* aad, uint32_t aadWords,
+	const uint32_t* in, uint32_t* out, uint32_t nrWords, const uint32_t* tag)
+{
+	uint32_t computed[GCM_TAG_WORDS];
+	uint32_t diff = 0;
+	uint32_t i;
+
+	start(context, iv, aad, aadWords);
+	GCM_ghash(context, in, nrWords);
+	CTR_crypt(&context->ctr, in, out, nrWords);
+	finish(context, aadWords, nrWords, computed);
+
+	for (i = 0; i < GCM_TAG_WORDS; i++)
+	{
+		diff |= computed[i] ^ tag[i];
+	}
+
+	return diff ? -1 : 0;
+}
@@ -16,17 +16,13 @@
 
 #include "GOST.h"
 #include "config.h"
+#include "cipher.h"
+#include "placement.h"
 
 #ifdef USE_GOST
 
-uint32_t CM1;
-uint32_t CM2;
-uint32_t N1;
-uint32_t N2;
-uint32_t R;
-
 // S-box used by the Central Bank of Russian Federation
-const uint8_t s_box[8][16] = {
+HOT_TABLE const uint8_t s_box[8][16] = {
 									{ 4, 10, 9, 2, 13, 8, 0, 14, 6, 11, 1, 12, 7, 15, 5, 3 },
 									{ 14, 11, 4, 12, 6, 13, 15, 10, 2, 3, 8, 1, 0, 7, 5, 9 },
 									{ 5, 8, 1, 13, 10, 3, 4, 2, 14, 15, 12, 7, 6, 0, 9, 11 },
@@ -37,9 +33,13 @@ const uint8_t s_box[8][16] = {
 									{ 1, 15, 13, 0, 5, 7, 10, 4, 9, 2, 3, 14, 6, 11, 8, 12 }
 };
 
-void GOST_round(uint32_t xi)
+// one round on the halves N1, N2 of the block (no global state, so the
+// cipher may be used from several threads)
+HOT_CODE static void GOST_round(uint32_t* N1, uint32_t* N2, uint32_t xi)
 {
-	CM1 = (N1 + xi) % 4294967296; // 2^32
+	uint32_t CM1, CM2, R;
+
+	CM1 = (*N1 + xi) % 4294967296; // 2^32
 
 	// read entire s-box column according to the CM1 bits
 	uint32_t SN = 0;
@@ -71,29 +71,29 @@ void GOST_round(uint32_t xi)
 	R = (R >> 21) | mask;
 
 	// modulo 2 addition
-	CM2 = R ^ N2;
-	N2 = N1;
-	N1 = CM2;
+	CM2 = R ^ *N2;
+	*N2 = *N1;
+	*N1 = CM2;
 }
 
-uint64_t GOST_encrypt(uint64_t block, uint32_t* key)
+HOT_CODE uint64_t GOST_encrypt(uint64_t block, uint32_t* key)
 {
-	N1 = (uint32_t)block;
-	N2 = block >> 32;
+	uint32_t N1 = (uint32_t)block;
+	uint32_t N2 = block >> 32;
 
 	// first 24 rounds
 	for (int k = 0; k < 3; k++)
 	{
 		for (int i = 0; i <= 7; i++)
 		{
-			GOST_round(key[i]);
+			GOST_round(&N1, &N2, key[i]);
 		}
 	}
 
 	// last 8 rounds
 	for (int i = 7; i >= 0; i--)
 	{
-		GOST_round(key[i]);
+		GOST_round(&N1, &N2, key[i]);
 	}
 
 	uint64_t tc = N1;
@@ -101,15 +101,15 @@ uint64_t GOST_encrypt(uint64_t block, uint32_t* key)
 	return tc;
 }
 
-uint64_t GOST_decrypt(uint64_t encryptedBlock, uint32_t* key)
+HOT_CODE uint64_t GOST_decrypt(uint64_t encryptedBlock, uint32_t* key)
 {
-	N1 = (uint32_t)encryptedBlock;
-	N2 = encryptedBlock >> 32;
+	uint32_t N1 = (uint32_t)encryptedBlock;
+	uint32_t N2 = encryptedBlock >> 32;
 
 	// last 8 rounds
 	for (int i = 0; i <= 7; i++)
 	{
-		GOST_round(key[i]);
+		GOST_round(&N1, &N2, key[i]);
 	}
 
 	// first 24 rounds
@@ -117,7 +117,7 @@ uint64_t GOST_decrypt(uint64_t encryptedBlock, uint32_t* key)
 	{
 		for (int i = 7; i >= 0; i--)
 		{
-			GOST_round(key[i]);
+			GOST_round(&N1, &N2, key[i]);
 		}
 	}
 
@@ -126,6 +126,47 @@ uint64_t GOST_decrypt(uint64_t encryptedBlock, uint32_t* key)
 	return tc;
 }
 
+// Block cipher interface (cipher.h)
+static void gostInit(CipherContext* context, const uint32_t* key, uint16_t keyLen)
+{
+	int i;
+
+	for (i = 0; i < 8; i++)
+	{
+		context->rawKey[i] = key[i];
+	}
+}
+
+HOT_CODE static void gostEncrypt(CipherContext* context, const uint32_t* in, uint32_t* out, uint32_t nrBlocks)
+{
+	uint64_t block;
+
+	for (; nrBlocks > 0; nrBlocks--)
+	{
+		block = GOST_encrypt((uint64_t)in[0] << 32 | in[1], context->rawKey);
+		out[0] = (uint32_t)(block >> 32);
+		out[1] = (uint32_t)block;
+		in += 2;
+		out += 2;
+	}
+}
+
+HOT_CODE static void gostDecrypt(CipherContext* context, const uint32_t* in, uint32_t* out, uint32_t nrBlocks)
+{
+	uint64_t block;
+
+	for (; nrBlocks > 0; nrBlocks--)
+	{
+		block = GOST_decrypt((uint64_t)in[0] << 32 | in[1], context->rawKey);
+		out[0] = (uint32_t)(block >> 32);
+		out[1] = (uint32_t)block;
+		in += 2;
+		out += 2;
+	}
+}
+
+const BlockCipher GOST_CIPHER = { "GOST", 2, 256, gostInit, gostEncrypt, gostDecrypt, 8 * sizeof(uint32_t) };
+
 int crypt_main(uint32_t* text, uint32_t* key){
 
 	uint64_t text_in = (text[0] << 32) | text[1];
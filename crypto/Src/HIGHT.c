@@ -18,6 +18,9 @@
 
 #include "HIGHT.h"
 #include "config.h"
+#include "cipher.h"
+#include "placement.h"
+#include "simd.h"
 
 #ifdef USE_HIGHT
 
@@ -36,7 +39,7 @@ static const uint8_t DELTA[128] = {
 	0x64, 0x32, 0x19, 0x0c, 0x46, 0x23, 0x51, 0x68, 0x74, 0x3a, 0x5d, 0x2e, 0x57, 0x6b, 0x35, 0x5a,
 };
 
-static uint8_t ROL_8(uint8_t x, uint8_t n)
+HOT_CODE static uint8_t ROL_8(uint8_t x, uint8_t n)
 {
 	return x << n | x >> (8 - n);
 }
@@ -58,17 +61,17 @@ static void constantGeneration()
 	}
 }*/
 
-static uint8_t f0(uint8_t x)
+HOT_CODE static uint8_t f0(uint8_t x)
 {
 	return ROL_8(x, 1) ^ ROL_8(x, 2) ^ ROL_8(x, 7);
 }
 
-static uint8_t f1(uint8_t x)
+HOT_CODE static uint8_t f1(uint8_t x)
 {
 	return ROL_8(x, 3) ^ ROL_8(x, 4) ^ ROL_8(x, 6);
 }
 
-static void HIGHT_round(uint8_t* x,
+HOT_CODE static void HIGHT_round(uint8_t* x,
 				  uint8_t subkey0,
 				  uint8_t subkey1,
 				  uint8_t subkey2,
@@ -87,7 +90,7 @@ static void HIGHT_round(uint8_t* x,
 	x[0] = temp7 ^ (f0(temp6) + subkey3);
 }
 
-static void HIGHT_inverse_round(uint8_t* x,
+HOT_CODE static void HIGHT_inverse_round(uint8_t* x,
 						  uint8_t subkey0,
 						  uint8_t subkey1,
 						  uint8_t subkey2,
@@ -105,6 +108,153 @@ static void HIGHT_inverse_round(uint8_t* x,
 	x[7] = temp ^ (f0(x[6]) + subkey0);
 }
 
+/*
+* Four blocks byte-sliced: byte i of every block shares word x[i], with
+* block 0 in the low byte and block 3 in the high byte. Additions and
+* subtractions mod 2^8 run on the four lanes at once with UADD8/USUB8,
+* XORs are word wide and rotations are done lane-wise with masks.
+*/
+
+// copy an 8-bit subkey to the four lanes of a word
+#define DUP8(k) ((uint32_t)(k) * 0x01010101)
+
+// rotate left each byte of the word by n bits
+#define ROL_8x4(x, n) ((((x) << (n)) & (0x01010101u * (uint8_t)(0xff << (n)))) \
+					| (((x) >> (8 - (n))) & (0x01010101u * (0xff >> (8 - (n))))))
+
+HOT_CODE static uint32_t f0x4(uint32_t x)
+{
+	return ROL_8x4(x, 1) ^ ROL_8x4(x, 2) ^ ROL_8x4(x, 7);
+}
+
+HOT_CODE static uint32_t f1x4(uint32_t x)
+{
+	return ROL_8x4(x, 3) ^ ROL_8x4(x, 4) ^ ROL_8x4(x, 6);
+}
+
+// gather byte i of 4 consecutive blocks into the lanes of x[i]
+HOT_CODE static void sliceBlocks(const uint8_t* blocks, uint32_t* x)
+{
+	int i;
+
+	for (i = 0; i < 8; i++)
+	{
+		x[i] = (uint32_t)blocks[i]
+			| (uint32_t)blocks[i + 8] << 8
+			| (uint32_t)blocks[i + 16] << 16
+			| (uint32_t)blocks[i + 24] << 24;
+	}
+}
+
+HOT_CODE static void unsliceBlocks(const uint32_t* x, uint8_t* blocks)
+{
+	int i;
+
+	for (i = 0; i < 8; i++)
+	{
+		blocks[i] = (uint8_t)x[i];
+		blocks[i + 8] = (uint8_t)(x[i] >> 8);
+		blocks[i + 16] = (uint8_t)(x[i] >> 16);
+		blocks[i + 24] = (uint8_t)(x[i] >> 24);
+	}
+}
+
+HOT_CODE static void HIGHT_encrypt_x4(HightContext* context, const uint8_t* blocks, uint8_t* out)
+{
+	uint8_t r;
+	const uint8_t* sk = context->subkeys;
+	const uint8_t* wk = context->whiteningKeys;
+	uint32_t x[8];
+	uint32_t y[8];
+	uint32_t temp6;
+	uint32_t temp7;
+
+	sliceBlocks(blocks, x);
+
+	// Initial Transformation
+	x[0] = UADD8(x[0], DUP8(wk[0]));
+	x[2] ^= DUP8(wk[1]);
+	x[4] = UADD8(x[4], DUP8(wk[2]));
+	x[6] ^= DUP8(wk[3]);
+
+	// Rounds
+	for (r = 0; r < NR_ROUNDS; r++)
+	{
+		temp6 = x[6];
+		temp7 = x[7];
+
+		x[7] = x[6];
+		x[6] = UADD8(x[5], f1x4(x[4]) ^ DUP8(sk[2]));
+		x[5] = x[4];
+		x[4] = x[3] ^ UADD8(f0x4(x[2]), DUP8(sk[1]));
+		x[3] = x[2];
+		x[2] = UADD8(x[1], f1x4(x[0]) ^ DUP8(sk[0]));
+		x[1] = x[0];
+		x[0] = temp7 ^ UADD8(f0x4(temp6), DUP8(sk[3]));
+
+		sk += 4;
+	}
+
+	// Final Transformation
+	y[0] = UADD8(x[1], DUP8(wk[4]));
+	y[1] = x[2];
+	y[2] = x[3] ^ DUP8(wk[5]);
+	y[3] = x[4];
+	y[4] = UADD8(x[5], DUP8(wk[6]));
+	y[5] = x[6];
+	y[6] = x[7] ^ DUP8(wk[7]);
+	y[7] = x[0];
+
+	unsliceBlocks(y, out);
+}
+
+HOT_CODE static void HIGHT_decrypt_x4(HightContext* context, const uint8_t* blocks, uint8_t* out)
+{
+	uint8_t r;
+	const uint8_t* sk = context->subkeys + 127;
+	const uint8_t* wk = context->whiteningKeys;
+	uint32_t x[8];
+	uint32_t y[8];
+	uint32_t temp;
+
+	sliceBlocks(blocks, y);
+
+	// Final Inverse Transformation
+	x[7] = y[6] ^ DUP8(wk[7]);
+	x[6] = y[5];
+	x[5] = USUB8(y[4], DUP8(wk[6]));
+	x[4] = y[3];
+	x[3] = y[2] ^ DUP8(wk[5]);
+	x[2] = y[1];
+	x[1] = USUB8(y[0], DUP8(wk[4]));
+	x[0] = y[7];
+
+	// Rounds
+	for (r = 0; r < NR_ROUNDS; r++)
+	{
+		temp = x[0];
+
+		x[0] = x[1];
+		x[1] = USUB8(x[2], f1x4(x[0]) ^ DUP8(sk[-3]));
+		x[2] = x[3];
+		x[3] = x[4] ^ UADD8(f0x4(x[2]), DUP8(sk[-2]));
+		x[4] = x[5];
+		x[5] = USUB8(x[6], f1x4(x[4]) ^ DUP8(sk[-1]));
+		x[6] = x[7];
+		x[7] = temp ^ UADD8(f0x4(x[6]), DUP8(sk[0]));
+
+		sk -= 4;
+	}
+
+	// Initial Inverse Transformation
+	x[0] = USUB8(x[0], DUP8(wk[0]));
+	x[2] ^= DUP8(wk[1]);
+	x[4] = USUB8(x[4], DUP8(wk[2]));
+	x[6] ^= DUP8(wk[3]);
+
+	unsliceBlocks(x, out);
+}
+
 void HIGHT_init(HightContext* context, uint8_t* key)
 {
 	int i;
@@ -134,7 +284,7 @@ void HIGHT_init(HightContext* context, uint8_t* key)
 	}
 }
 
-void HIGHT_encrypt(HightContext* context, uint8_t* block, uint8_t* out)
+HOT_CODE void HIGHT_encrypt(HightContext* context, uint8_t* block, uint8_t* out)
 {
 	uint8_t r;
 	uint8_t subkey = 0;
@@ -168,7 +318,7 @@ void HIGHT_encrypt(HightContext* context, uint8_t* block, uint8_t* out)
 	out[7] = x[0];
 }
 
-void HIGHT_decrypt(HightContext* context, uint8_t* block, uint8_t* out)
+HOT_CODE void HIGHT_decrypt(HightContext* context, uint8_t* block, uint8_t* out)
 {
 	uint8_t r;
 	uint8_t subkey = 127;
@@ -202,6 +352,117 @@ void HIGHT_decrypt(HightContext* context, uint8_t* block, uint8_t* out)
 	out[7] = x[7];
 }
 
+// ECB over nrBlocks blocks, four at a time, the remainder one by one
+HOT_CODE void HIGHT_encrypt_ecb(HightContext* context, const uint8_t* blocks, uint8_t* out, uint32_t nrBlocks)
+{
+	for (; nrBlocks >= 4; nrBlocks -= 4)
+	{
+		HIGHT_encrypt_x4(context, blocks, out);
+		blocks += 32;
+		out += 32;
+	}
+
+	for (; nrBlocks > 0; nrBlocks--)
+	{
+		HIGHT_encrypt(context, (uint8_t*)blocks, out);
+		blocks += 8;
+		out += 8;
+	}
+}
+
+HOT_CODE void HIGHT_decrypt_ecb(HightContext* context, const uint8_t* blocks, uint8_t* out, uint32_t nrBlocks)
+{
+	for (; nrBlocks >= 4; nrBlocks -= 4)
+	{
+		HIGHT_decrypt_x4(context, blocks, out);
+		blocks += 32;
+		out += 32;
+	}
+
+	for (; nrBlocks > 0; nrBlocks--)
+	{
+		HIGHT_decrypt(context, (uint8_t*)blocks, out);
+		blocks += 8;
+		out += 8;
+	}
+}
+
+// Block cipher interface (cipher.h)
+
+// blocks converted per call of the bulk kernel
+#define CHUNK_BLOCKS 8
+
+static void hightInit(CipherContext* context, const uint32_t* key, uint16_t keyLen)
+{
+	uint8_t key_in[16];
+
+	CIPHER_store_words(key, key_in, 4);
+	HIGHT_init(&context->hight, key_in);
+}
+
+HOT_CODE static void hightEncrypt(CipherContext* context, const uint32_t* in, uint32_t* out, uint32_t nrBlocks)
+{
+	uint8_t block[8];
+
+	for (; nrBlocks > 0; nrBlocks--)
+	{
+		CIPHER_store_words(in, block, 2);
+		HIGHT_encrypt(&context->hight, block, block);
+		CIPHER_load_words(block, out, 2);
+		in += 2;
+		out += 2;
+	}
+}
+
+HOT_CODE static void hightDecrypt(CipherContext* context, const uint32_t* in, uint32_t* out, uint32_t nrBlocks)
+{
+	uint8_t block[8];
+
+	for (; nrBlocks > 0; nrBlocks--)
+	{
+		CIPHER_store_words(in, block, 2);
+		HIGHT_decrypt(&context->hight, block, block);
+		CIPHER_load_words(block, out, 2);
+		in += 2;
+		out += 2;
+	}
+}
+
+HOT_CODE static void hightEncryptX4(CipherContext* context, const uint32_t* in, uint32_t* out, uint32_t nrBlocks)
+{
+	uint8_t blocks[8 * CHUNK_BLOCKS];
+	uint32_t n;
+
+	for (; nrBlocks > 0; nrBlocks -= n)
+	{
+		n = nrBlocks < CHUNK_BLOCKS ? nrBlocks : CHUNK_BLOCKS;
+		CIPHER_store_words(in, blocks, 2 * n);
+		HIGHT_encrypt_ecb(&context->hight, blocks, blocks, n);
+		CIPHER_load_words(blocks, out, 2 * n);
+		in += 2 * n;
+		out += 2 * n;
+	}
+}
+
+HOT_CODE static void hightDecryptX4(CipherContext* context, const uint32_t* in, uint32_t* out, uint32_t nrBlocks)
+{
+	uint8_t blocks[8 * CHUNK_BLOCKS];
+	uint32_t n;
+
+	for (; nrBlocks > 0; nrBlocks -= n)
+	{
+		n = nrBlocks < CHUNK_BLOCKS ? nrBlocks : CHUNK_BLOCKS;
+		CIPHER_store_words(in, blocks, 2 * n);
+		HIGHT_decrypt_ecb(&context->hight, blocks, blocks, n);
+		CIPHER_load_words(blocks, out, 2 * n);
+		in += 2 * n;
+		out += 2 * n;
+	}
+}
+
+const BlockCipher HIGHT_CIPHER = { "HIGHT", 2, 128, hightInit, hightEncrypt, hightDecrypt, sizeof(HightContext) };
+const BlockCipher HIGHT_X4_CIPHER = { "HIGHT-x4", 2, 128, hightInit, hightEncryptX4, hightDecryptX4, sizeof(HightContext) };
+
 int crypt_main(uint32_t* text, uint32_t* key)
 {
 	HightContext context;
@@ -17,13 +17,16 @@
 
 #include "IDEA.h"
 #include "config.h"
+#include "cipher.h"
+#include "placement.h"
+#include "simd.h"
 
 #ifdef USE_IDEA
 
 #define NR_ROUNDS 8
 #define ENCRYPTION_KEY_LEN 6 * NR_ROUNDS + 4 // 52 subkeys
 
-static uint16_t mul(uint16_t a, uint16_t b)
+HOT_CODE static uint16_t mul(uint16_t a, uint16_t b)
 {
 	long p;
 	unsigned long q;
@@ -42,36 +45,43 @@ static uint16_t mul(uint16_t a, uint16_t b)
 }
 
 /*
-* Euclidean multiplicative mod 65537 inverse algorithm
+* Branch-free multiplication modulo 2^16 + 1, where 0 stands for 2^16.
+* Both operands are mapped to 1..2^16 and the 17x17 bits product is formed
+* with a single UMULL, so there is no special case for zero operands and
+* the timing does not depend on the data.
 */
-static uint16_t inv(uint16_t x)
+HOT_CODE static uint32_t mulCT(uint32_t a, uint32_t b)
 {
-	uint16_t t0 = 1, t1;
-	uint16_t q, y;
+	uint64_t p;
+	uint32_t r;
+
+	a = ((a - 1) & 0xffff) + 1;
+	b = ((b - 1) & 0xffff) + 1;
 
-	if (x <= 1)
-		return x;	// 0 and 1 are self-inverse 
+	p = (uint64_t)a * b;
+	r = ((uint32_t)p & 0xffff) - (uint32_t)(p >> 16);
 
-	t1 = 0x10001L / x;	// Since x >= 2, this fits into 16 bits 
-	y = 0x10001L % x;
+	// add the modulus back when the subtraction went negative
+	r += (uint32_t)((int32_t)r >> 31) & 0x10001;
+	return r & 0xffff;
+}
 
-	if (y == 1)
-		return 1 - t1;
+/*
+* Multiplicative mod 65537 inverse computed as x^(65537 - 2) with a fixed
+* square-and-multiply chain (exponent 0xffff), so key setup runs in
+* constant time. 0 (2^16) and 1 are self-inverse, as expected.
+*/
+static uint16_t inv(uint16_t x)
+{
+	uint32_t t = x;
+	int i;
 
-	do
+	for (i = 0; i < 15; i++)
 	{
-		q = x / y;
-		x = x % y;
-		t0 += q * t1;
-		if (x == 1)
-			return t0;
-		q = y / x;
-		y = y % x;
-		t1 += q * t0;
+		t = mulCT(mulCT(t, t), x);
 	}
-	while (y != 1);
 
-	return 1 - t1;
+	return (uint16_t)t;
 }
 
 static void generateEncryptionKeys(uint16_t* key, uint16_t Z[52])
@@ -147,7 +157,7 @@ static void generateDecryptionKeys(uint16_t* key, uint16_t Z[52])
 	memcpy(Z, temp, sizeof(temp));
 }
 
-static void idea(uint16_t* block, uint16_t* Z, uint16_t* out)
+HOT_CODE static void idea(uint16_t* block, uint16_t* Z, uint16_t* out)
 {
 	uint16_t i;
 	uint16_t a;
@@ -186,22 +196,214 @@ static void idea(uint16_t* block, uint16_t* Z, uint16_t* out)
 	out[3] = mul(*Z++, x3);
 }
 
+// copy a 16-bit subkey to both lanes of a word
+#define DUP16(z) ((uint32_t)(z) * 0x00010001)
+
+// multiply both 16-bit lanes by the same subkey
+HOT_CODE static uint32_t mul2(uint32_t z, uint32_t x)
+{
+	return mulCT(z, x & 0xffff) | (mulCT(z, x >> 16) << 16);
+}
+
+/*
+* Two blocks interleaved: lane 0 (low half) of each word carries the
+* first block and lane 1 (high half) the second one. Additions mod 2^16
+* run on both lanes at once with UADD16, XORs are lane independent and
+* the multiplications use the branch-free mulCT.
+*/
+HOT_CODE static void idea2(const uint16_t* blocks, const uint16_t* Z, uint16_t* out)
+{
+	uint16_t i;
+	uint32_t a;
+	uint32_t b;
+	uint32_t x0 = blocks[0] | (uint32_t)blocks[4] << 16;
+	uint32_t x1 = blocks[1] | (uint32_t)blocks[5] << 16;
+	uint32_t x2 = blocks[2] | (uint32_t)blocks[6] << 16;
+	uint32_t x3 = blocks[3] | (uint32_t)blocks[7] << 16;
+
+	// round phase
+	for (i = 1; i <= NR_ROUNDS; i++)
+	{
+		// confusion / group operations
+		x0 = mul2(*Z++, x0);
+		x1 = UADD16(x1, DUP16(*Z++));
+		x2 = UADD16(x2, DUP16(*Z++));
+		x3 = mul2(*Z++, x3);
+
+		// diffusion / MA (multiplication-addition) structure
+		b = mul2(*Z++, x0 ^ x2);
+		a = mul2(*Z++, UADD16(b, x1 ^ x3));
+		b = UADD16(b, a);
+
+		// involuntary permutation
+		x0 = a ^ x0;
+		x3 = b ^ x3;
+		b ^= x1;
+		x1 = a ^ x2;
+		x2 = b;
+	}
+
+	// output transformation
+	x0 = mul2(*Z++, x0);
+	a = UADD16(DUP16(*Z++), x2);
+	b = UADD16(DUP16(*Z++), x1);
+	x3 = mul2(*Z++, x3);
+
+	out[0] = (uint16_t)x0;
+	out[1] = (uint16_t)a;
+	out[2] = (uint16_t)b;
+	out[3] = (uint16_t)x3;
+	out[4] = (uint16_t)(x0 >> 16);
+	out[5] = (uint16_t)(a >> 16);
+	out[6] = (uint16_t)(b >> 16);
+	out[7] = (uint16_t)(x3 >> 16);
+}
+
+/*
+* ECB over nrBlocks blocks of 4 words, two blocks per kernel call.
+* An odd last block runs through the same kernel with both lanes loaded
+* with it, so every block takes the constant-time path.
+*/
+HOT_CODE static void ideaECB(const uint16_t* blocks, const uint16_t* Z, uint16_t* out, uint32_t nrBlocks)
+{
+	uint16_t pair[8];
+
+	for (; nrBlocks >= 2; nrBlocks -= 2)
+	{
+		idea2(blocks, Z, out);
+		blocks += 8;
+		out += 8;
+	}
+
+	if (nrBlocks)
+	{
+		memcpy(pair, blocks, 4 * sizeof(uint16_t));
+		memcpy(pair + 4, blocks, 4 * sizeof(uint16_t));
+		idea2(pair, Z, pair);
+		memcpy(out, pair, 4 * sizeof(uint16_t));
+	}
+}
+
 void IDEA_init(IdeaContext* context, uint16_t* key)
 {
 	generateEncryptionKeys(key, context->encryptionKeys);
 	generateDecryptionKeys(context->encryptionKeys, context->decryptionKeys);
 }
 
-void IDEA_encrypt(IdeaContext* context, uint16_t* block, uint16_t* out)
+HOT_CODE void IDEA_encrypt(IdeaContext* context, uint16_t* block, uint16_t* out)
 {
 	idea(block, context->encryptionKeys, out);
 }
 
-void IDEA_decrypt(IdeaContext* context, uint16_t* encryptedBlock, uint16_t* out)
+HOT_CODE void IDEA_decrypt(IdeaContext* context, uint16_t* encryptedBlock, uint16_t* out)
 {
 	idea(encryptedBlock, context->decryptionKeys, out);
 }
 
+HOT_CODE void IDEA_encrypt_ecb(IdeaContext* context, const uint16_t* blocks, uint16_t* out, uint32_t nrBlocks)
+{
+	ideaECB(blocks, context->encryptionKeys, out, nrBlocks);
+}
+
+HOT_CODE void IDEA_decrypt_ecb(IdeaContext* context, const uint16_t* encryptedBlocks, uint16_t* out, uint32_t nrBlocks)
+{
+	ideaECB(encryptedBlocks, context->decryptionKeys, out, nrBlocks);
+}
+
+// Block cipher interface (cipher.h)
+
+// blocks converted per call of the bulk kernel
+#define CHUNK_BLOCKS 8
+
+HOT_CODE static void wordsToHalves(const uint32_t* words, uint16_t* halves, uint32_t nrWords)
+{
+	for (; nrWords > 0; nrWords--)
+	{
+		*halves++ = (uint16_t)(*words >> 16);
+		*halves++ = (uint16_t)*words++;
+	}
+}
+
+HOT_CODE static void halvesToWords(const uint16_t* halves, uint32_t* words, uint32_t nrWords)
+{
+	for (; nrWords > 0; nrWords--)
+	{
+		*words++ = (uint32_t)halves[0] << 16 | halves[1];
+		halves += 2;
+	}
+}
+
+static void ideaInit(CipherContext* context, const uint32_t* key, uint16_t keyLen)
+{
+	uint16_t key_in[8];
+
+	wordsToHalves(key, key_in, 4);
+	IDEA_init(&context->idea, key_in);
+}
+
+HOT_CODE static void ideaEncrypt(CipherContext* context, const uint32_t* in, uint32_t* out, uint32_t nrBlocks)
+{
+	uint16_t block[4];
+
+	for (; nrBlocks > 0; nrBlocks--)
+	{
+		wordsToHalves(in, block, 2);
+		IDEA_encrypt(&context->idea, block, block);
+		halvesToWords(block, out, 2);
+		in += 2;
+		out += 2;
+	}
+}
+
+HOT_CODE static void ideaDecrypt(CipherContext* context, const uint32_t* in, uint32_t* out, uint32_t nrBlocks)
+{
+	uint16_t block[4];
+
+	for (; nrBlocks > 0; nrBlocks--)
+	{
+		wordsToHalves(in, block, 2);
+		IDEA_decrypt(&context->idea, block, block);
+		halvesToWords(block, out, 2);
+		in += 2;
+		out += 2;
+	}
+}
+
+HOT_CODE static void ideaEncryptX2(CipherContext* context, const uint32_t* in, uint32_t* out, uint32_t nrBlocks)
+{
+	uint16_t blocks[4 * CHUNK_BLOCKS];
+	uint32_t n;
+
+	for (; nrBlocks > 0; nrBlocks -= n)
+	{
+		n = nrBlocks < CHUNK_BLOCKS ? nrBlocks : CHUNK_BLOCKS;
+		wordsToHalves(in, blocks, 2 * n);
+		IDEA_encrypt_ecb(&context->idea, blocks, blocks, n);
+		halvesToWords(blocks, out, 2 * n);
+		in += 2 * n;
+		out += 2 * n;
+	}
+}
+
+HOT_CODE static void ideaDecryptX2(CipherContext* context, const uint32_t* in, uint32_t* out, uint32_t nrBlocks)
+{
+	uint16_t blocks[4 * CHUNK_BLOCKS];
+	uint32_t n;
+
+	for (; nrBlocks > 0; nrBlocks -= n)
+	{
+		n = nrBlocks < CHUNK_BLOCKS ? nrBlocks : CHUNK_BLOCKS;
+		wordsToHalves(in, blocks, 2 * n);
+		IDEA_decrypt_ecb(&context->idea, blocks, blocks, n);
+		halvesToWords(blocks, out, 2 * n);
+		in += 2 * n;
+		out += 2 * n;
+	}
+}
+
+const BlockCipher IDEA_CIPHER = { "IDEA", 2, 128, ideaInit, ideaEncrypt, ideaDecrypt, sizeof(IdeaContext) };
+const BlockCipher IDEA_X2_CIPHER = { "IDEA-x2", 2, 128, ideaInit, ideaEncryptX2, ideaDecryptX2, sizeof(IdeaContext) };
+
 int crypt_main(uint32_t* text, uint32_t* key)
 {
 	IdeaContext context;
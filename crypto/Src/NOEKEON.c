@@ -4,7 +4,8 @@
  * Created: 27/07/2021
  *
  * Implementation of the NOEKEON block cipher with
- * 128 bits block length and 128 bits key length.
+ * 128 bits block length and 128 bits key length,
+ * direct-key and indirect-key modes.
  *
  * This code follows a specification:
  *		- http://gro.noekeon.org/Noekeon-spec.pdf
@@ -18,13 +19,15 @@
 
 #include "NOEKEON.h"
 #include "config.h"
+#include "cipher.h"
+#include "placement.h"
 
 #ifdef USE_NOEKEON
 
 
 #define NR_ROUNDS 16
 
-static const uint32_t RC[] =
+HOT_TABLE static const uint32_t RC[] =
 {
    0x80, 0x1b, 0x36, 0x6c,
    0xd8, 0xab, 0x4d, 0x9a,
@@ -33,12 +36,12 @@ static const uint32_t RC[] =
    0xd4
 };
 
-static const uint32_t NULL_VECTOR[] =
+HOT_TABLE static const uint32_t NULL_VECTOR[] =
 {
 	0x00, 0x00, 0x00, 0x00
 };
 
-static void MOV_128(uint32_t* y, uint32_t* x)
+HOT_CODE static void MOV_128(uint32_t* y, uint32_t* x)
 {
 	y[0] = x[0];
 	y[1] = x[1];
@@ -47,32 +50,32 @@ static void MOV_128(uint32_t* y, uint32_t* x)
 }
 
 // Rotate Left circular shift 32 bits
-static uint32_t ROL_32(uint32_t x, uint32_t n)
+HOT_CODE static uint32_t ROL_32(uint32_t x, uint32_t n)
 {
 	return x << n | x >> (32 - n);
 }
 
 // Rotate Right circular shift 32 bits
-static uint32_t ROR_32(uint32_t x, uint32_t n)
+HOT_CODE static uint32_t ROR_32(uint32_t x, uint32_t n)
 {
 	return x >> n | x << (32 - n);
 }
 
-static void pi1(uint32_t* a)
+HOT_CODE static void pi1(uint32_t* a)
 {
 	a[1] = ROL_32(a[1], 1);
 	a[2] = ROL_32(a[2], 5);
 	a[3] = ROL_32(a[3], 2);
 }
 
-static void pi2(uint32_t* a)
+HOT_CODE static void pi2(uint32_t* a)
 {
 	a[1] = ROR_32(a[1], 1);
 	a[2] = ROR_32(a[2], 5);
 	a[3] = ROR_32(a[3], 2);
 }
 
-static void gamma(uint32_t* a)
+HOT_CODE static void gamma(uint32_t* a)
 {
 	uint32_t tmp;
 
@@ -88,7 +91,7 @@ static void gamma(uint32_t* a)
 	a[0] ^= a[2] & a[1];
 }
 
-static void theta(const uint32_t* k, uint32_t* a)
+HOT_CODE static void theta(const uint32_t* k, uint32_t* a)
 {
 	uint32_t temp = a[0] ^ a[2];
 	temp ^= ROR_32(temp, 8) ^ ROL_32(temp, 8);
@@ -108,7 +111,7 @@ static void theta(const uint32_t* k, uint32_t* a)
 	a[2] ^= temp;
 }
 
-static void NOEKEON_round(uint32_t* key, uint32_t* block, uint32_t c1, uint32_t c2)
+HOT_CODE static void NOEKEON_round(uint32_t* key, uint32_t* block, uint32_t c1, uint32_t c2)
 {
 	block[0] ^= c1;
 	theta(key, block);
@@ -118,7 +121,7 @@ static void NOEKEON_round(uint32_t* key, uint32_t* block, uint32_t c1, uint32_t
 	pi2(block);
 }
 
-void NOEKEON_encrypt(uint32_t* block, uint32_t* key, uint32_t* encryptdBlock)
+HOT_CODE void NOEKEON_encrypt(uint32_t* block, uint32_t* key, uint32_t* encryptdBlock)
 {
 	MOV_128(encryptdBlock, block);
 	for (int i = 0; i < NR_ROUNDS; i++)
@@ -130,7 +133,7 @@ void NOEKEON_encrypt(uint32_t* block, uint32_t* key, uint32_t* encryptdBlock)
 	theta(key, encryptdBlock);
 }
 
-void NOEKEON_decrypt(uint32_t* encryptedBlock, uint32_t* key, uint32_t* decryptedBlock)
+HOT_CODE void NOEKEON_decrypt(uint32_t* encryptedBlock, uint32_t* key, uint32_t* decryptedBlock)
 {
 	uint32_t workingKey[4];
 
@@ -148,6 +151,176 @@ void NOEKEON_decrypt(uint32_t* encryptedBlock, uint32_t* key, uint32_t* decrypte
 	decryptedBlock[0] ^= RC[0];
 }
 
+/*
+* Both working keys are computed once by NOEKEON_init. The kernels keep the
+* state in four register variables and unroll the 16 rounds, with the round
+* constants as immediates.
+*/
+
+void NOEKEON_init(NoekeonContext* context, const uint32_t* key, uint8_t mode)
+{
+	if (mode == NOEKEON_INDIRECT)
+	{
+		NOEKEON_encrypt((uint32_t*)key, (uint32_t*)NULL_VECTOR, context->encryptionKey);
+	}
+	else
+	{
+		MOV_128(context->encryptionKey, (uint32_t*)key);
+	}
+
+	MOV_128(context->decryptionKey, context->encryptionKey);
+	theta(NULL_VECTOR, context->decryptionKey);
+}
+
+#define NOEKEON_ROUNDS(R) R(0) R(1) R(2) R(3) R(4) R(5) R(6) R(7) \
+	R(8) R(9) R(10) R(11) R(12) R(13) R(14) R(15)
+#define NOEKEON_INV_ROUNDS(R) R(16) R(15) R(14) R(13) R(12) R(11) R(10) R(9) \
+	R(8) R(7) R(6) R(5) R(4) R(3) R(2) R(1)
+
+#define THETA(k) \
+	t = a0 ^ a2; \
+	t ^= ROR_32(t, 8) ^ ROL_32(t, 8); \
+	a1 ^= t; \
+	a3 ^= t; \
+	a0 ^= k[0]; \
+	a1 ^= k[1]; \
+	a2 ^= k[2]; \
+	a3 ^= k[3]; \
+	t = a1 ^ a3; \
+	t ^= ROR_32(t, 8) ^ ROL_32(t, 8); \
+	a0 ^= t; \
+	a2 ^= t;
+
+#define PI1_GAMMA_PI2 \
+	a1 = ROL_32(a1, 1); \
+	a2 = ROL_32(a2, 5); \
+	a3 = ROL_32(a3, 2); \
+	a1 ^= ~a3 & ~a2; \
+	a0 ^= a2 & a1; \
+	t = a3; \
+	a3 = a0; \
+	a0 = t; \
+	a2 ^= a0 ^ a1 ^ a3; \
+	a1 ^= ~a3 & ~a2; \
+	a0 ^= a2 & a1; \
+	a1 = ROR_32(a1, 1); \
+	a2 = ROR_32(a2, 5); \
+	a3 = ROR_32(a3, 2);
+
+#define ENC_ROUND(i) \
+	a0 ^= RC[i]; \
+	THETA(k) \
+	PI1_GAMMA_PI2
+
+#define DEC_ROUND(i) \
+	THETA(k) \
+	a0 ^= RC[i]; \
+	PI1_GAMMA_PI2
+
+HOT_CODE void NOEKEON_encrypt_ecb(NoekeonContext* context, const uint32_t* blocks, uint32_t* out, uint32_t nrBlocks)
+{
+	const uint32_t* k = context->encryptionKey;
+	register uint32_t a0, a1, a2, a3;
+	register uint32_t t;
+
+	for (; nrBlocks > 0; nrBlocks--)
+	{
+		a0 = blocks[0];
+		a1 = blocks[1];
+		a2 = blocks[2];
+		a3 = blocks[3];
+
+		NOEKEON_ROUNDS(ENC_ROUND)
+
+		a0 ^= RC[NR_ROUNDS];
+		THETA(k)
+
+		out[0] = a0;
+		out[1] = a1;
+		out[2] = a2;
+		out[3] = a3;
+		blocks += 4;
+		out += 4;
+	}
+}
+
+HOT_CODE void NOEKEON_decrypt_ecb(NoekeonContext* context, const uint32_t* blocks, uint32_t* out, uint32_t nrBlocks)
+{
+	const uint32_t* k = context->decryptionKey;
+	register uint32_t a0, a1, a2, a3;
+	register uint32_t t;
+
+	for (; nrBlocks > 0; nrBlocks--)
+	{
+		a0 = blocks[0];
+		a1 = blocks[1];
+		a2 = blocks[2];
+		a3 = blocks[3];
+
+		NOEKEON_INV_ROUNDS(DEC_ROUND)
+
+		THETA(k)
+		a0 ^= RC[0];
+
+		out[0] = a0;
+		out[1] = a1;
+		out[2] = a2;
+		out[3] = a3;
+		blocks += 4;
+		out += 4;
+	}
+}
+
+// Block cipher interface (cipher.h)
+static void noekeonInit(CipherContext* context, const uint32_t* key, uint16_t keyLen)
+{
+	MOV_128(context->rawKey, (uint32_t*)key);
+}
+
+HOT_CODE static void noekeonEncrypt(CipherContext* context, const uint32_t* in, uint32_t* out, uint32_t nrBlocks)
+{
+	for (; nrBlocks > 0; nrBlocks--)
+	{
+		NOEKEON_encrypt((uint32_t*)in, context->rawKey, out);
+		in += 4;
+		out += 4;
+	}
+}
+
+HOT_CODE static void noekeonDecrypt(CipherContext* context, const uint32_t* in, uint32_t* out, uint32_t nrBlocks)
+{
+	for (; nrBlocks > 0; nrBlocks--)
+	{
+		NOEKEON_decrypt((uint32_t*)in, context->rawKey, out);
+		in += 4;
+		out += 4;
+	}
+}
+
+static void noekeonInitDirect(CipherContext* context, const uint32_t* key, uint16_t keyLen)
+{
+	NOEKEON_init(&context->noekeon, key, NOEKEON_DIRECT);
+}
+
+static void noekeonInitIndirect(CipherContext* context, const uint32_t* key, uint16_t keyLen)
+{
+	NOEKEON_init(&context->noekeon, key, NOEKEON_INDIRECT);
+}
+
+HOT_CODE static void noekeonEncryptEcb(CipherContext* context, const uint32_t* in, uint32_t* out, uint32_t nrBlocks)
+{
+	NOEKEON_encrypt_ecb(&context->noekeon, in, out, nrBlocks);
+}
+
+HOT_CODE static void noekeonDecryptEcb(CipherContext* context, const uint32_t* in, uint32_t* out, uint32_t nrBlocks)
+{
+	NOEKEON_decrypt_ecb(&context->noekeon, in, out, nrBlocks);
+}
+
+const BlockCipher NOEKEON_CIPHER = { "NOEKEON", 4, 128, noekeonInit, noekeonEncrypt, noekeonDecrypt, 4 * sizeof(uint32_t) };
+const BlockCipher NOEKEON_DIRECT_CIPHER = { "NOEKEON-direct", 4, 128, noekeonInitDirect, noekeonEncryptEcb, noekeonDecryptEcb, sizeof(NoekeonContext) };
+const BlockCipher NOEKEON_INDIRECT_CIPHER = { "NOEKEON-indirect", 4, 128, noekeonInitIndirect, noekeonEncryptEcb, noekeonDecryptEcb, sizeof(NoekeonContext) };
+
 int crypt_main(uint32_t* text, uint32_t* key)
 
 {
@@ -18,25 +18,27 @@
 
 #include "PRESENT.h"
 #include "config.h"
+#include "cipher.h"
+#include "placement.h"
 
 #ifdef USE_PRESENT
 
 #define NR_ROUNDS 31
 
 // s-box
-const uint8_t sbox[16] =
+HOT_TABLE const uint8_t sbox[16] =
 {
 	0xc, 0x5, 0x6, 0xb, 0x9, 0x0, 0xa, 0xd, 0x3, 0xe, 0xf, 0x8, 0x4, 0x7, 0x1, 0x2
 };
 
 // inverse s-box
-const uint8_t isbox[16] =
+HOT_TABLE const uint8_t isbox[16] =
 {
 	0x5, 0xe, 0xf, 0x8, 0xc, 0x1, 0x2, 0xd, 0xb, 0x4, 0x6, 0x3, 0x0, 0x7, 0x9, 0xa
 };
 
 // permutation table
-const uint8_t p[64] =
+HOT_TABLE const uint8_t p[64] =
 {
 	0, 16, 32, 48, 1, 17, 33, 49, 2, 18, 34, 50, 3, 19, 35, 51,
 	4, 20, 36, 52, 5, 21, 37, 53, 6, 22, 38, 54, 7, 23, 39, 55,
@@ -126,7 +128,7 @@ void PRESENT_init(PresentContext* context, uint16_t* key, uint16_t keyLen)
 
 	addRoundKey(state, k31)
 */
-void PRESENT_encrypt(PresentContext* context, uint16_t* block, uint16_t* out)
+HOT_CODE void PRESENT_encrypt(PresentContext* context, uint16_t* block, uint16_t* out)
 {
 	uint8_t i;
 	uint8_t round;
@@ -195,7 +197,7 @@ void PRESENT_encrypt(PresentContext* context, uint16_t* block, uint16_t* out)
 
 	addRoundKey(state, k0)
 */
-void PRESENT_decrypt(PresentContext* context, uint16_t* block, uint16_t* out)
+HOT_CODE void PRESENT_decrypt(PresentContext* context, uint16_t* block, uint16_t* out)
 {
 	uint8_t i;
 	uint8_t round;
@@ -255,6 +257,57 @@ void PRESENT_decrypt(PresentContext* context, uint16_t* block, uint16_t* out)
 	out[3] = (uint16_t)state;
 }
 
+// Block cipher interface (cipher.h)
+HOT_CODE static void wordsToHalves(const uint32_t* words, uint16_t* halves, uint32_t nrWords)
+{
+	for (; nrWords > 0; nrWords--)
+	{
+		*halves++ = (uint16_t)(*words >> 16);
+		*halves++ = (uint16_t)*words++;
+	}
+}
+
+static void presentInit(CipherContext* context, const uint32_t* key, uint16_t keyLen)
+{
+	uint16_t key_in[8];
+
+	wordsToHalves(key, key_in, 4);
+	PRESENT_init(&context->present, key_in, keyLen);
+}
+
+HOT_CODE static void presentEncrypt(CipherContext* context, const uint32_t* in, uint32_t* out, uint32_t nrBlocks)
+{
+	uint16_t block[4];
+
+	for (; nrBlocks > 0; nrBlocks--)
+	{
+		wordsToHalves(in, block, 2);
+		PRESENT_encrypt(&context->present, block, block);
+		out[0] = (uint32_t)block[0] << 16 | block[1];
+		out[1] = (uint32_t)block[2] << 16 | block[3];
+		in += 2;
+		out += 2;
+	}
+}
+
+HOT_CODE static void presentDecrypt(CipherContext* context, const uint32_t* in, uint32_t* out, uint32_t nrBlocks)
+{
+	uint16_t block[4];
+
+	for (; nrBlocks > 0; nrBlocks--)
+	{
+		wordsToHalves(in, block, 2);
+		PRESENT_decrypt(&context->present, block, block);
+		out[0] = (uint32_t)block[0] << 16 | block[1];
+		out[1] = (uint32_t)block[2] << 16 | block[3];
+		in += 2;
+		out += 2;
+	}
+}
+
+const BlockCipher PRESENT_80_CIPHER = { "PRESENT-80", 2, 80, presentInit, presentEncrypt, presentDecrypt, sizeof(PresentContext) };
+const BlockCipher PRESENT_128_CIPHER = { "PRESENT-128", 2, 128, presentInit, presentEncrypt, presentDecrypt, sizeof(PresentContext) };
+
 int crypt_main(uint32_t* text, uint32_t* key)
 {
 	PresentContext context;
@@ -18,6 +18,8 @@
 
 #include "SEED.h"
 #include "config.h"
+#include "cipher.h"
+#include "placement.h"
 
 #ifdef USE_SEED
 
@@ -32,7 +34,7 @@ static const uint32_t KC[16] =
 };
 
 //S-Box SS0
-static const uint32_t ss0[256] =
+HOT_TABLE static const uint32_t ss0[256] =
 {
    0x2989A1A8, 0x05858184, 0x16C6D2D4, 0x13C3D3D0, 0x14445054, 0x1D0D111C, 0x2C8CA0AC, 0x25052124,
    0x1D4D515C, 0x03434340, 0x18081018, 0x1E0E121C, 0x11415150, 0x3CCCF0FC, 0x0ACAC2C8, 0x23436360,
@@ -69,7 +71,7 @@ static const uint32_t ss0[256] =
 };
 
 //S-Box SS1
-static const uint32_t ss1[256] =
+HOT_TABLE static const uint32_t ss1[256] =
 {
    0x38380830, 0xE828C8E0, 0x2C2D0D21, 0xA42686A2, 0xCC0FCFC3, 0xDC1ECED2, 0xB03383B3, 0xB83888B0,
    0xAC2F8FA3, 0x60204060, 0x54154551, 0xC407C7C3, 0x44044440, 0x6C2F4F63, 0x682B4B63, 0x581B4B53,
@@ -106,7 +108,7 @@ static const uint32_t ss1[256] =
 };
 
 //S-Box SS2
-static const uint32_t ss2[256] =
+HOT_TABLE static const uint32_t ss2[256] =
 {
    0xA1A82989, 0x81840585, 0xD2D416C6, 0xD3D013C3, 0x50541444, 0x111C1D0D, 0xA0AC2C8C, 0x21242505,
    0x515C1D4D, 0x43400343, 0x10181808, 0x121C1E0E, 0x51501141, 0xF0FC3CCC, 0xC2C80ACA, 0x63602343,
@@ -143,7 +145,7 @@ static const uint32_t ss2[256] =
 };
 
 //S-Box SS3
-static const uint32_t ss3[256] =
+HOT_TABLE static const uint32_t ss3[256] =
 {
    0x08303838, 0xC8E0E828, 0x0D212C2D, 0x86A2A426, 0xCFC3CC0F, 0xCED2DC1E, 0x83B3B033, 0x88B0B838,
    0x8FA3AC2F, 0x40606020, 0x45515415, 0xC7C3C407, 0x44404404, 0x4F636C2F, 0x4B63682B, 0x4B53581B,
@@ -185,13 +187,13 @@ static const uint32_t ss3[256] =
 	divide input into 4 parts of 8 bits each and substitute in s-boxes
 	and xor them
 */
-static uint32_t G(uint32_t x)
+HOT_CODE static uint32_t G(uint32_t x)
 {
 	return ss0[x & 0xFF] ^ ss1[(x >> 8) & 0xFF] ^ ss2[(x >> 16) & 0xFF] ^ ss3[(x >> 24) & 0xFF];
 }
 
 // Diffusion layer
-static void F(uint32_t R0, uint32_t R1,
+HOT_CODE static void F(uint32_t R0, uint32_t R1,
 			  uint32_t Ki0, uint32_t Ki1,
 			  uint32_t* out0, uint32_t* out1)
 {
@@ -233,7 +235,7 @@ void SEED_init(SeedContext* context, uint32_t* key)
 	}
 }
 
-void SEED_encrypt(SeedContext* context, uint32_t* block, uint32_t* out)
+HOT_CODE void SEED_encrypt(SeedContext* context, uint32_t* block, uint32_t* out)
 {
 	int i;
 	uint32_t temp0;
@@ -280,7 +282,7 @@ void SEED_encrypt(SeedContext* context, uint32_t* block, uint32_t* out)
 	out[3] = r1;
 }
 
-void SEED_decrypt(SeedContext* context, uint32_t* block, uint32_t* out)
+HOT_CODE void SEED_decrypt(SeedContext* context, uint32_t* block, uint32_t* out)
 {
 	int i;
 	uint32_t temp0;
@@ -327,6 +329,37 @@ void SEED_decrypt(SeedContext* context, uint32_t* block, uint32_t* out)
 	out[3] = r1;
 }
 
+// Block cipher interface (cipher.h)
+static void seedInit(CipherContext* context, const uint32_t* key, uint16_t keyLen)
+{
+	// SEED_init rotates the key words it is given, keep the caller's key intact
+	uint32_t key_in[4] = { key[0], key[1], key[2], key[3] };
+
+	SEED_init(&context->seed, key_in);
+}
+
+HOT_CODE static void seedEncrypt(CipherContext* context, const uint32_t* in, uint32_t* out, uint32_t nrBlocks)
+{
+	for (; nrBlocks > 0; nrBlocks--)
+	{
+		SEED_encrypt(&context->seed, (uint32_t*)in, out);
+		in += 4;
+		out += 4;
+	}
+}
+
+HOT_CODE static void seedDecrypt(CipherContext* context, const uint32_t* in, uint32_t* out, uint32_t nrBlocks)
+{
+	for (; nrBlocks > 0; nrBlocks--)
+	{
+		SEED_decrypt(&context->seed, (uint32_t*)in, out);
+		in += 4;
+		out += 4;
+	}
+}
+
+const BlockCipher SEED_CIPHER = { "SEED", 4, 128, seedInit, seedEncrypt, seedDecrypt, sizeof(SeedContext) };
+
 int crypt_main(uint32_t* text, uint32_t* key)
 {
 	SeedContext context;
@@ -4,7 +4,8 @@
  * Created: 09/08/2021
  *
  * Implementation of the SIMON block cipher with
- * 128 bits block length and 128/192/256 bits key length.
+ * 128 bits block length and 128/192/256 bits key length,
+ * and 64 bits block length and 96/128 bits key length.
  *
  * This code follows a specification:
  *		- https://eprint.iacr.org/2013/404.pdf
@@ -16,11 +17,13 @@
 
 #include "SIMON.h"
 #include "config.h"
+#include "cipher.h"
+#include "placement.h"
 
 #ifdef USE_SIMON
 
 // Rotate Left circular shift 32 bits
-static uint64_t ROL_64(uint64_t x, uint32_t n)
+HOT_CODE static uint64_t ROL_64(uint64_t x, uint32_t n)
 {
 	return x << n | x >> (64 - n);
 }
@@ -31,12 +34,12 @@ static uint64_t ROR_64(uint64_t x, uint32_t n)
 	return x >> n | x << (64 - n);
 }
 
-static uint64_t f(uint64_t x)
+HOT_CODE static uint64_t f(uint64_t x)
 {
 	return (ROL_64(x, 1) & ROL_64(x, 8)) ^ ROL_64(x, 2);
 }
 
-static void R2(uint64_t* x, uint64_t* y, uint64_t k, uint64_t l)
+HOT_CODE static void R2(uint64_t* x, uint64_t* y, uint64_t k, uint64_t l)
 {
 	*y ^= f(*x);
 	*y ^= k;
@@ -111,7 +114,7 @@ void SIMON_init(SimonContext* context, uint64_t* key, uint16_t keyLen)
 	}
 }
 
-void SIMON_encrypt(SimonContext* context, uint64_t* block, uint64_t* out)
+HOT_CODE void SIMON_encrypt(SimonContext* context, uint64_t* block, uint64_t* out)
 {
 	uint8_t i;
 	uint64_t x = block[0];
@@ -143,7 +146,7 @@ void SIMON_encrypt(SimonContext* context, uint64_t* block, uint64_t* out)
 	out[1] = y;
 }
 
-void SIMON_decrypt(SimonContext* context, uint64_t* block, uint64_t* out)
+HOT_CODE void SIMON_decrypt(SimonContext* context, uint64_t* block, uint64_t* out)
 {
 	int i;
 	uint64_t x = block[0];
@@ -175,6 +178,433 @@ void SIMON_decrypt(SimonContext* context, uint64_t* block, uint64_t* out)
 	out[1] = y;
 }
 
+/*
+* Simon128 on 32-bit register pairs: every 64-bit word is kept as a high and
+* a low half, f() is computed on both halves with 32-bit shifts. The blocks
+* are read and written in the word packing of crypt_main.
+*/
+
+// rotation of the 64-bit word h:l left by n < 32 bits, high and low half of the result
+#define ROL_HI(h, l, n) ((h) << (n) | (l) >> (32 - (n)))
+#define ROL_LO(h, l, n) ((l) << (n) | (h) >> (32 - (n)))
+
+#define F_HI(h, l) ((ROL_HI(h, l, 1) & ROL_HI(h, l, 8)) ^ ROL_HI(h, l, 2))
+#define F_LO(h, l) ((ROL_LO(h, l, 1) & ROL_LO(h, l, 8)) ^ ROL_LO(h, l, 2))
+
+HOT_CODE void SIMON_encrypt_ecb(SimonContext* context, const uint32_t* blocks, uint32_t* out, uint32_t nrBlocks)
+{
+	uint8_t i;
+	uint8_t nrRounds = context->nrSubkeys & ~1;
+	const uint64_t* k;
+	uint32_t xh, xl, yh, yl;
+	uint32_t t;
+
+	for (; nrBlocks > 0; nrBlocks--)
+	{
+		xh = blocks[0];
+		xl = blocks[1];
+		yh = blocks[2];
+		yl = blocks[3];
+		k = context->subkeys;
+
+		// two rounds per iteration, as R2
+		for (i = 0; i < nrRounds; i += 2)
+		{
+			yh ^= F_HI(xh, xl) ^ (uint32_t)(k[0] >> 32);
+			yl ^= F_LO(xh, xl) ^ (uint32_t)k[0];
+			xh ^= F_HI(yh, yl) ^ (uint32_t)(k[1] >> 32);
+			xl ^= F_LO(yh, yl) ^ (uint32_t)k[1];
+			k += 2;
+		}
+
+		// odd number of rounds (192 bits key)
+		if (context->nrSubkeys & 1)
+		{
+			yh ^= F_HI(xh, xl) ^ (uint32_t)(k[0] >> 32);
+			yl ^= F_LO(xh, xl) ^ (uint32_t)k[0];
+			t = xh;
+			xh = yh;
+			yh = t;
+			t = xl;
+			xl = yl;
+			yl = t;
+		}
+
+		out[0] = xh;
+		out[1] = xl;
+		out[2] = yh;
+		out[3] = yl;
+		blocks += 4;
+		out += 4;
+	}
+}
+
+HOT_CODE void SIMON_decrypt_ecb(SimonContext* context, const uint32_t* blocks, uint32_t* out, uint32_t nrBlocks)
+{
+	uint8_t i;
+	uint8_t nrRounds = context->nrSubkeys & ~1;
+	const uint64_t* k;
+	uint32_t xh, xl, yh, yl;
+	uint32_t t;
+
+	for (; nrBlocks > 0; nrBlocks--)
+	{
+		xh = blocks[0];
+		xl = blocks[1];
+		yh = blocks[2];
+		yl = blocks[3];
+
+		if (context->nrSubkeys & 1)
+		{
+			t = xh;
+			xh = yh;
+			yh = t;
+			t = xl;
+			xl = yl;
+			yl = t;
+			yh ^= F_HI(xh, xl) ^ (uint32_t)(context->subkeys[nrRounds] >> 32);
+			yl ^= F_LO(xh, xl) ^ (uint32_t)context->subkeys[nrRounds];
+		}
+
+		k = context->subkeys + nrRounds - 1;
+
+		for (i = 0; i < nrRounds; i += 2)
+		{
+			xh ^= F_HI(yh, yl) ^ (uint32_t)(k[0] >> 32);
+			xl ^= F_LO(yh, yl) ^ (uint32_t)k[0];
+			yh ^= F_HI(xh, xl) ^ (uint32_t)(k[-1] >> 32);
+			yl ^= F_LO(xh, xl) ^ (uint32_t)k[-1];
+			k -= 2;
+		}
+
+		out[0] = xh;
+		out[1] = xl;
+		out[2] = yh;
+		out[3] = yl;
+		blocks += 4;
+		out += 4;
+	}
+}
+
+/*
+* Fully unrolled Simon128 kernels, one per key length, generated from the
+* double round macros below and an X-macro list of the subkey indices of
+* every key length. The round count is a compile time constant, the subkey
+* offsets are immediates and the state is declared register, which GCC
+* honours at -O0 too. They stay in flash whatever PLACEMENT is
+* (placement.h): the six of them would take most of the 32 KB of SRAM2.
+*/
+
+// double rounds on subkeys i .. i+7, in encryption and in decryption order
+#define SIMON_X4(R, i) R(i) R(i + 2) R(i + 4) R(i + 6)
+#define SIMON_INV_X4(R, i) R(i + 6) R(i + 4) R(i + 2) R(i)
+
+#define SIMON_ROUNDS_64(R) SIMON_X4(R, 0) SIMON_X4(R, 8) SIMON_X4(R, 16) SIMON_X4(R, 24) \
+	SIMON_X4(R, 32) SIMON_X4(R, 40) SIMON_X4(R, 48) SIMON_X4(R, 56)
+#define SIMON_ROUNDS_128(R) SIMON_ROUNDS_64(R) R(64) R(66)
+#define SIMON_ROUNDS_256(R) SIMON_ROUNDS_128(R) R(68) R(70)
+
+#define SIMON_INV_ROUNDS_64(R) SIMON_INV_X4(R, 56) SIMON_INV_X4(R, 48) SIMON_INV_X4(R, 40) SIMON_INV_X4(R, 32) \
+	SIMON_INV_X4(R, 24) SIMON_INV_X4(R, 16) SIMON_INV_X4(R, 8) SIMON_INV_X4(R, 0)
+#define SIMON_INV_ROUNDS_128(R) R(66) R(64) SIMON_INV_ROUNDS_64(R)
+#define SIMON_INV_ROUNDS_256(R) R(70) R(68) SIMON_INV_ROUNDS_128(R)
+
+// two rounds on subkeys i and i+1, as R2
+#define SIMON_ROUND2(i) \
+	yh ^= F_HI(xh, xl) ^ (uint32_t)(k[i] >> 32); \
+	yl ^= F_LO(xh, xl) ^ (uint32_t)k[i]; \
+	xh ^= F_HI(yh, yl) ^ (uint32_t)(k[(i) + 1] >> 32); \
+	xl ^= F_LO(yh, yl) ^ (uint32_t)k[(i) + 1];
+
+#define SIMON_INV_ROUND2(i) \
+	xh ^= F_HI(yh, yl) ^ (uint32_t)(k[(i) + 1] >> 32); \
+	xl ^= F_LO(yh, yl) ^ (uint32_t)k[(i) + 1]; \
+	yh ^= F_HI(xh, xl) ^ (uint32_t)(k[i] >> 32); \
+	yl ^= F_LO(xh, xl) ^ (uint32_t)k[i];
+
+// single last round of the 192 bits key (69 rounds), halves swapped
+#define SIMON_ROUND_SWAP(i) \
+	yh ^= F_HI(xh, xl) ^ (uint32_t)(k[i] >> 32); \
+	yl ^= F_LO(xh, xl) ^ (uint32_t)k[i]; \
+	t = xh; xh = yh; yh = t; \
+	t = xl; xl = yl; yl = t;
+
+#define SIMON_INV_ROUND_SWAP(i) \
+	t = xh; xh = yh; yh = t; \
+	t = xl; xl = yl; yl = t; \
+	yh ^= F_HI(xh, xl) ^ (uint32_t)(k[i] >> 32); \
+	yl ^= F_LO(xh, xl) ^ (uint32_t)k[i];
+
+#define SIMON_KERNEL(name, ROUNDS) \
+static void name(const uint64_t* k, const uint32_t* blocks, uint32_t* out, uint32_t nrBlocks) \
+{ \
+	register uint32_t xh, xl, yh, yl; \
+	register uint32_t t; \
+	\
+	for (; nrBlocks > 0; nrBlocks--) \
+	{ \
+		xh = blocks[0]; \
+		xl = blocks[1]; \
+		yh = blocks[2]; \
+		yl = blocks[3]; \
+		\
+		ROUNDS \
+		\
+		out[0] = xh; \
+		out[1] = xl; \
+		out[2] = yh; \
+		out[3] = yl; \
+		blocks += 4; \
+		out += 4; \
+	} \
+	(void)t; \
+}
+
+SIMON_KERNEL(SIMON_encrypt_128, SIMON_ROUNDS_128(SIMON_ROUND2))
+SIMON_KERNEL(SIMON_encrypt_192, SIMON_ROUNDS_128(SIMON_ROUND2) SIMON_ROUND_SWAP(68))
+SIMON_KERNEL(SIMON_encrypt_256, SIMON_ROUNDS_256(SIMON_ROUND2))
+SIMON_KERNEL(SIMON_decrypt_128, SIMON_INV_ROUNDS_128(SIMON_INV_ROUND2))
+SIMON_KERNEL(SIMON_decrypt_192, SIMON_INV_ROUND_SWAP(68) SIMON_INV_ROUNDS_128(SIMON_INV_ROUND2))
+SIMON_KERNEL(SIMON_decrypt_256, SIMON_INV_ROUNDS_256(SIMON_INV_ROUND2))
+
+void SIMON_encrypt_unrolled(SimonContext* context, const uint32_t* blocks, uint32_t* out, uint32_t nrBlocks)
+{
+	switch (context->nrSubkeys)
+	{
+	case 68:
+		SIMON_encrypt_128(context->subkeys, blocks, out, nrBlocks);
+		break;
+	case 69:
+		SIMON_encrypt_192(context->subkeys, blocks, out, nrBlocks);
+		break;
+	default:
+		SIMON_encrypt_256(context->subkeys, blocks, out, nrBlocks);
+		break;
+	}
+}
+
+void SIMON_decrypt_unrolled(SimonContext* context, const uint32_t* blocks, uint32_t* out, uint32_t nrBlocks)
+{
+	switch (context->nrSubkeys)
+	{
+	case 68:
+		SIMON_decrypt_128(context->subkeys, blocks, out, nrBlocks);
+		break;
+	case 69:
+		SIMON_decrypt_192(context->subkeys, blocks, out, nrBlocks);
+		break;
+	default:
+		SIMON_decrypt_256(context->subkeys, blocks, out, nrBlocks);
+		break;
+	}
+}
+
+/*
+* Simon64: the same rounds on native 32-bit words.
+*/
+
+HOT_CODE static uint32_t ROL_32(uint32_t x, uint32_t n)
+{
+	return x << n | x >> (32 - n);
+}
+
+static uint32_t ROR_32(uint32_t x, uint32_t n)
+{
+	return x >> n | x << (32 - n);
+}
+
+HOT_CODE static uint32_t f32(uint32_t x)
+{
+	return (ROL_32(x, 1) & ROL_32(x, 8)) ^ ROL_32(x, 2);
+}
+
+HOT_CODE static void R2_32(uint32_t* x, uint32_t* y, uint32_t k, uint32_t l)
+{
+	*y ^= f32(*x);
+	*y ^= k;
+	*x ^= f32(*y);
+	*x ^= l;
+}
+
+void SIMON64_init(Simon64Context* context, const uint32_t* key, uint16_t keyLen)
+{
+	uint32_t c = 0xfffffffc;
+	uint64_t z;
+	uint32_t t;
+	uint8_t m = keyLen / 32; // key words: 3 or 4
+	uint8_t i;
+
+	if (keyLen == 96)
+	{
+		context->nrSubkeys = 42;
+		z = 0x7369f885192c0ef5LL; // z2
+	}
+	else // 128
+	{
+		context->nrSubkeys = 44;
+		z = 0xfc2ce51207a635dbLL; // z3
+	}
+
+	for (i = 0; i < m; i++)
+	{
+		context->subkeys[i] = key[m - 1 - i];
+	}
+
+	for (i = m; i < context->nrSubkeys; i++)
+	{
+		t = ROR_32(context->subkeys[i - 1], 3);
+		if (m == 4)
+		{
+			t ^= context->subkeys[i - 3];
+		}
+		t ^= ROR_32(t, 1);
+
+		context->subkeys[i] = c ^ (z & 1) ^ context->subkeys[i - m] ^ t;
+		z >>= 1;
+	}
+}
+
+HOT_CODE void SIMON64_encrypt(Simon64Context* context, const uint32_t* block, uint32_t* out)
+{
+	uint8_t i;
+	uint32_t x = block[0];
+	uint32_t y = block[1];
+
+	for (i = 0; i < context->nrSubkeys; i += 2)
+	{
+		R2_32(&x, &y, context->subkeys[i], context->subkeys[i + 1]);
+	}
+
+	out[0] = x;
+	out[1] = y;
+}
+
+HOT_CODE void SIMON64_decrypt(Simon64Context* context, const uint32_t* block, uint32_t* out)
+{
+	int i;
+	uint32_t x = block[0];
+	uint32_t y = block[1];
+
+	for (i = context->nrSubkeys - 1; i >= 0; i -= 2)
+	{
+		R2_32(&y, &x, context->subkeys[i], context->subkeys[i - 1]);
+	}
+
+	out[0] = x;
+	out[1] = y;
+}
+
+// Block cipher interface (cipher.h)
+static void simonInit(CipherContext* context, const uint32_t* key, uint16_t keyLen)
+{
+	uint64_t key_in[4];
+	int i;
+
+	for (i = 0; i < keyLen / 64; i++)
+	{
+		key_in[i] = (uint64_t)key[2 * i] << 32 | key[2 * i + 1];
+	}
+
+	SIMON_init(&context->simon, key_in, keyLen);
+}
+
+HOT_CODE static void simonEncrypt(CipherContext* context, const uint32_t* in, uint32_t* out, uint32_t nrBlocks)
+{
+	uint64_t block[2];
+
+	for (; nrBlocks > 0; nrBlocks--)
+	{
+		block[0] = (uint64_t)in[0] << 32 | in[1];
+		block[1] = (uint64_t)in[2] << 32 | in[3];
+
+		SIMON_encrypt(&context->simon, block, block);
+
+		out[0] = (uint32_t)(block[0] >> 32);
+		out[1] = (uint32_t)block[0];
+		out[2] = (uint32_t)(block[1] >> 32);
+		out[3] = (uint32_t)block[1];
+		in += 4;
+		out += 4;
+	}
+}
+
+HOT_CODE static void simonDecrypt(CipherContext* context, const uint32_t* in, uint32_t* out, uint32_t nrBlocks)
+{
+	uint64_t block[2];
+
+	for (; nrBlocks > 0; nrBlocks--)
+	{
+		block[0] = (uint64_t)in[0] << 32 | in[1];
+		block[1] = (uint64_t)in[2] << 32 | in[3];
+
+		SIMON_decrypt(&context->simon, block, block);
+
+		out[0] = (uint32_t)(block[0] >> 32);
+		out[1] = (uint32_t)block[0];
+		out[2] = (uint32_t)(block[1] >> 32);
+		out[3] = (uint32_t)block[1];
+		in += 4;
+		out += 4;
+	}
+}
+
+HOT_CODE static void simonEncryptPair(CipherContext* context, const uint32_t* in, uint32_t* out, uint32_t nrBlocks)
+{
+	SIMON_encrypt_ecb(&context->simon, in, out, nrBlocks);
+}
+
+HOT_CODE static void simonDecryptPair(CipherContext* context, const uint32_t* in, uint32_t* out, uint32_t nrBlocks)
+{
+	SIMON_decrypt_ecb(&context->simon, in, out, nrBlocks);
+}
+
+static void simonEncryptUnrolled(CipherContext* context, const uint32_t* in, uint32_t* out, uint32_t nrBlocks)
+{
+	SIMON_encrypt_unrolled(&context->simon, in, out, nrBlocks);
+}
+
+static void simonDecryptUnrolled(CipherContext* context, const uint32_t* in, uint32_t* out, uint32_t nrBlocks)
+{
+	SIMON_decrypt_unrolled(&context->simon, in, out, nrBlocks);
+}
+
+static void simon64Init(CipherContext* context, const uint32_t* key, uint16_t keyLen)
+{
+	SIMON64_init(&context->simon64, key, keyLen);
+}
+
+HOT_CODE static void simon64Encrypt(CipherContext* context, const uint32_t* in, uint32_t* out, uint32_t nrBlocks)
+{
+	for (; nrBlocks > 0; nrBlocks--)
+	{
+		SIMON64_encrypt(&context->simon64, in, out);
+		in += 2;
+		out += 2;
+	}
+}
+
+HOT_CODE static void simon64Decrypt(CipherContext* context, const uint32_t* in, uint32_t* out, uint32_t nrBlocks)
+{
+	for (; nrBlocks > 0; nrBlocks--)
+	{
+		SIMON64_decrypt(&context->simon64, in, out);
+		in += 2;
+		out += 2;
+	}
+}
+
+const BlockCipher SIMON_128_CIPHER = { "SIMON-128", 4, 128, simonInit, simonEncrypt, simonDecrypt, sizeof(SimonContext) };
+const BlockCipher SIMON_192_CIPHER = { "SIMON-192", 4, 192, simonInit, simonEncrypt, simonDecrypt, sizeof(SimonContext) };
+const BlockCipher SIMON_256_CIPHER = { "SIMON-256", 4, 256, simonInit, simonEncrypt, simonDecrypt, sizeof(SimonContext) };
+const BlockCipher SIMON_128_PAIR_CIPHER = { "SIMON-128-pair", 4, 128, simonInit, simonEncryptPair, simonDecryptPair, sizeof(SimonContext) };
+const BlockCipher SIMON_192_PAIR_CIPHER = { "SIMON-192-pair", 4, 192, simonInit, simonEncryptPair, simonDecryptPair, sizeof(SimonContext) };
+const BlockCipher SIMON_256_PAIR_CIPHER = { "SIMON-256-pair", 4, 256, simonInit, simonEncryptPair, simonDecryptPair, sizeof(SimonContext) };
+const BlockCipher SIMON_128_UNROLLED_CIPHER = { "SIMON-128-unrolled", 4, 128, simonInit, simonEncryptUnrolled, simonDecryptUnrolled, sizeof(SimonContext) };
+const BlockCipher SIMON_192_UNROLLED_CIPHER = { "SIMON-192-unrolled", 4, 192, simonInit, simonEncryptUnrolled, simonDecryptUnrolled, sizeof(SimonContext) };
+const BlockCipher SIMON_256_UNROLLED_CIPHER = { "SIMON-256-unrolled", 4, 256, simonInit, simonEncryptUnrolled, simonDecryptUnrolled, sizeof(SimonContext) };
+const BlockCipher SIMON64_96_CIPHER = { "SIMON64-96", 2, 96, simon64Init, simon64Encrypt, simon64Decrypt, sizeof(Simon64Context) };
+const BlockCipher SIMON64_128_CIPHER = { "SIMON64-128", 2, 128, simon64Init, simon64Encrypt, simon64Decrypt, sizeof(Simon64Context) };
+
 int crypt_main(uint32_t* text, uint32_t* key)
 {
 	SimonContext context;
@@ -4,7 +4,8 @@
  * Created: 08/08/2021
  *
  * Implementation of the SPECK block cipher with
- * 128 bits block length and 128/192/256 bits key length.
+ * 128 bits block length and 128/192/256 bits key length,
+ * and 64 bits block length and 96/128 bits key length.
  *
  * This code follows a specification:
  *		- https://eprint.iacr.org/2013/404.pdf
@@ -16,23 +17,25 @@
 
 #include "SPECK.h"
 #include "config.h"
+#include "cipher.h"
+#include "placement.h"
 
 #ifdef USE_SPECK
 
 
 // Rotate Left circular shift 32 bits
-static uint64_t ROL_64(uint64_t x, uint32_t n)
+HOT_CODE static uint64_t ROL_64(uint64_t x, uint32_t n)
 {
 	return x << n | x >> (64 - n);
 }
 
 // Rotate Right circular shift 32 bits
-static uint64_t ROR_64(uint64_t x, uint32_t n)
+HOT_CODE static uint64_t ROR_64(uint64_t x, uint32_t n)
 {
 	return x >> n | x << (64 - n);
 }
 
-static void R(uint64_t* x, uint64_t* y, uint64_t k)
+HOT_CODE static void R(uint64_t* x, uint64_t* y, uint64_t k)
 {
 	*x = ROR_64(*x, 8);
 	*x += *y;
@@ -41,7 +44,7 @@ static void R(uint64_t* x, uint64_t* y, uint64_t k)
 	*y ^= *x;
 }
 
-static void RI(uint64_t* x, uint64_t* y, uint64_t k)
+HOT_CODE static void RI(uint64_t* x, uint64_t* y, uint64_t k)
 {
 	*y ^= *x;
 	*y = ROR_64(*y, 3);
@@ -110,7 +113,7 @@ void SPECK_init(SpeckContext* context, uint64_t* key, uint16_t keyLen)
 	}
 }
 
-void SPECK_encrypt(SpeckContext* context, uint64_t* block, uint64_t* out)
+HOT_CODE void SPECK_encrypt(SpeckContext* context, uint64_t* block, uint64_t* out)
 {
 	uint8_t i;
 	uint64_t x = block[0];
@@ -125,7 +128,7 @@ void SPECK_encrypt(SpeckContext* context, uint64_t* block, uint64_t* out)
 	out[1] = y;
 }
 
-void SPECK_decrypt(SpeckContext* context, uint64_t* block, uint64_t* out)
+HOT_CODE void SPECK_decrypt(SpeckContext* context, uint64_t* block, uint64_t* out)
 {
 	int i;
 	uint64_t x = block[0];
@@ -140,6 +143,404 @@ void SPECK_decrypt(SpeckContext* context, uint64_t* block, uint64_t* out)
 	out[1] = y;
 }
 
+/*
+* Speck128 on 32-bit register pairs: every 64-bit word is kept as a high and
+* a low half, so the rotations are two shifts per half and the addition
+* carries explicitly from the low half. The blocks are read and written in
+* the word packing of crypt_main, no conversion to uint64_t needed.
+*/
+
+// rotations of the 64-bit word h:l by n < 32 bits, high and low half of the result
+#define ROL_HI(h, l, n) ((h) << (n) | (l) >> (32 - (n)))
+#define ROL_LO(h, l, n) ((l) << (n) | (h) >> (32 - (n)))
+#define ROR_HI(h, l, n) ((h) >> (n) | (l) << (32 - (n)))
+#define ROR_LO(h, l, n) ((l) >> (n) | (h) << (32 - (n)))
+
+HOT_CODE void SPECK_encrypt_ecb(SpeckContext* context, const uint32_t* blocks, uint32_t* out, uint32_t nrBlocks)
+{
+	uint8_t i;
+	uint32_t xh, xl, yh, yl;
+	uint32_t t;
+
+	for (; nrBlocks > 0; nrBlocks--)
+	{
+		xh = blocks[0];
+		xl = blocks[1];
+		yh = blocks[2];
+		yl = blocks[3];
+
+		for (i = 0; i < context->nrSubkeys; i++)
+		{
+			// x = (ROR_64(x, 8) + y) ^ k
+			t = xh;
+			xh = ROR_HI(xh, xl, 8);
+			xl = ROR_LO(t, xl, 8);
+			xl += yl;
+			xh += yh + (xl < yl);
+			xh ^= (uint32_t)(context->subkeys[i] >> 32);
+			xl ^= (uint32_t)context->subkeys[i];
+
+			// y = ROL_64(y, 3) ^ x
+			t = yh;
+			yh = ROL_HI(yh, yl, 3) ^ xh;
+			yl = ROL_LO(t, yl, 3) ^ xl;
+		}
+
+		out[0] = xh;
+		out[1] = xl;
+		out[2] = yh;
+		out[3] = yl;
+		blocks += 4;
+		out += 4;
+	}
+}
+
+HOT_CODE void SPECK_decrypt_ecb(SpeckContext* context, const uint32_t* blocks, uint32_t* out, uint32_t nrBlocks)
+{
+	int i;
+	uint32_t xh, xl, yh, yl;
+	uint32_t t;
+
+	for (; nrBlocks > 0; nrBlocks--)
+	{
+		xh = blocks[0];
+		xl = blocks[1];
+		yh = blocks[2];
+		yl = blocks[3];
+
+		for (i = context->nrSubkeys - 1; i >= 0; i--)
+		{
+			// y = ROR_64(y ^ x, 3)
+			yh ^= xh;
+			yl ^= xl;
+			t = yh;
+			yh = ROR_HI(yh, yl, 3);
+			yl = ROR_LO(t, yl, 3);
+
+			// x = ROL_64((x ^ k) - y, 8)
+			xh ^= (uint32_t)(context->subkeys[i] >> 32);
+			xl ^= (uint32_t)context->subkeys[i];
+			xh -= yh + (xl < yl);
+			xl -= yl;
+			t = xh;
+			xh = ROL_HI(xh, xl, 8);
+			xl = ROL_LO(t, xl, 8);
+		}
+
+		out[0] = xh;
+		out[1] = xl;
+		out[2] = yh;
+		out[3] = yl;
+		blocks += 4;
+		out += 4;
+	}
+}
+
+/*
+* Fully unrolled Speck128 kernels, one per key length, generated from the
+* round macros below and an X-macro list of the subkey indices of every key
+* length. The round count is a compile time constant, the subkey offsets are
+* immediates and the state is declared register, which GCC honours at -O0
+* too. They stay in flash whatever PLACEMENT is (placement.h): the six of
+* them would take most of the 32 KB of SRAM2.
+*/
+
+// subkey indices i .. i+7, in encryption and in decryption order
+#define SPECK_X8(R, i) R(i) R(i + 1) R(i + 2) R(i + 3) R(i + 4) R(i + 5) R(i + 6) R(i + 7)
+#define SPECK_INV_X8(R, i) R(i + 7) R(i + 6) R(i + 5) R(i + 4) R(i + 3) R(i + 2) R(i + 1) R(i)
+
+#define SPECK_ROUNDS_128(R) SPECK_X8(R, 0) SPECK_X8(R, 8) SPECK_X8(R, 16) SPECK_X8(R, 24)
+#define SPECK_ROUNDS_192(R) SPECK_ROUNDS_128(R) R(32)
+#define SPECK_ROUNDS_256(R) SPECK_ROUNDS_192(R) R(33)
+
+#define SPECK_INV_ROUNDS_128(R) SPECK_INV_X8(R, 24) SPECK_INV_X8(R, 16) SPECK_INV_X8(R, 8) SPECK_INV_X8(R, 0)
+#define SPECK_INV_ROUNDS_192(R) R(32) SPECK_INV_ROUNDS_128(R)
+#define SPECK_INV_ROUNDS_256(R) R(33) SPECK_INV_ROUNDS_192(R)
+
+#define SPECK_ROUND(i) \
+	t = xh; \
+	xh = ROR_HI(xh, xl, 8); \
+	xl = ROR_LO(t, xl, 8); \
+	xl += yl; \
+	xh += yh + (xl < yl); \
+	xh ^= (uint32_t)(k[i] >> 32); \
+	xl ^= (uint32_t)k[i]; \
+	t = yh; \
+	yh = ROL_HI(yh, yl, 3) ^ xh; \
+	yl = ROL_LO(t, yl, 3) ^ xl;
+
+#define SPECK_INV_ROUND(i) \
+	yh ^= xh; \
+	yl ^= xl; \
+	t = yh; \
+	yh = ROR_HI(yh, yl, 3); \
+	yl = ROR_LO(t, yl, 3); \
+	xh ^= (uint32_t)(k[i] >> 32); \
+	xl ^= (uint32_t)k[i]; \
+	xh -= yh + (xl < yl); \
+	xl -= yl; \
+	t = xh; \
+	xh = ROL_HI(xh, xl, 8); \
+	xl = ROL_LO(t, xl, 8);
+
+#define SPECK_KERNEL(name, ROUNDS) \
+static void name(const uint64_t* k, const uint32_t* blocks, uint32_t* out, uint32_t nrBlocks) \
+{ \
+	register uint32_t xh, xl, yh, yl; \
+	register uint32_t t; \
+	\
+	for (; nrBlocks > 0; nrBlocks--) \
+	{ \
+		xh = blocks[0]; \
+		xl = blocks[1]; \
+		yh = blocks[2]; \
+		yl = blocks[3]; \
+		\
+		ROUNDS \
+		\
+		out[0] = xh; \
+		out[1] = xl; \
+		out[2] = yh; \
+		out[3] = yl; \
+		blocks += 4; \
+		out += 4; \
+	} \
+}
+
+SPECK_KERNEL(SPECK_encrypt_128, SPECK_ROUNDS_128(SPECK_ROUND))
+SPECK_KERNEL(SPECK_encrypt_192, SPECK_ROUNDS_192(SPECK_ROUND))
+SPECK_KERNEL(SPECK_encrypt_256, SPECK_ROUNDS_256(SPECK_ROUND))
+SPECK_KERNEL(SPECK_decrypt_128, SPECK_INV_ROUNDS_128(SPECK_INV_ROUND))
+SPECK_KERNEL(SPECK_decrypt_192, SPECK_INV_ROUNDS_192(SPECK_INV_ROUND))
+SPECK_KERNEL(SPECK_decrypt_256, SPECK_INV_ROUNDS_256(SPECK_INV_ROUND))
+
+void SPECK_encrypt_unrolled(SpeckContext* context, const uint32_t* blocks, uint32_t* out, uint32_t nrBlocks)
+{
+	switch (context->nrSubkeys)
+	{
+	case 32:
+		SPECK_encrypt_128(context->subkeys, blocks, out, nrBlocks);
+		break;
+	case 33:
+		SPECK_encrypt_192(context->subkeys, blocks, out, nrBlocks);
+		break;
+	default:
+		SPECK_encrypt_256(context->subkeys, blocks, out, nrBlocks);
+		break;
+	}
+}
+
+void SPECK_decrypt_unrolled(SpeckContext* context, const uint32_t* blocks, uint32_t* out, uint32_t nrBlocks)
+{
+	switch (context->nrSubkeys)
+	{
+	case 32:
+		SPECK_decrypt_128(context->subkeys, blocks, out, nrBlocks);
+		break;
+	case 33:
+		SPECK_decrypt_192(context->subkeys, blocks, out, nrBlocks);
+		break;
+	default:
+		SPECK_decrypt_256(context->subkeys, blocks, out, nrBlocks);
+		break;
+	}
+}
+
+/*
+* Speck64: the same round on native 32-bit words.
+*/
+
+HOT_CODE static uint32_t ROL_32(uint32_t x, uint32_t n)
+{
+	return x << n | x >> (32 - n);
+}
+
+HOT_CODE static uint32_t ROR_32(uint32_t x, uint32_t n)
+{
+	return x >> n | x << (32 - n);
+}
+
+HOT_CODE static void R32(uint32_t* x, uint32_t* y, uint32_t k)
+{
+	*x = ROR_32(*x, 8);
+	*x += *y;
+	*x ^= k;
+	*y = ROL_32(*y, 3);
+	*y ^= *x;
+}
+
+HOT_CODE static void RI32(uint32_t* x, uint32_t* y, uint32_t k)
+{
+	*y ^= *x;
+	*y = ROR_32(*y, 3);
+	*x ^= k;
+	*x -= *y;
+	*x = ROL_32(*x, 8);
+}
+
+void SPECK64_init(Speck64Context* context, const uint32_t* key, uint16_t keyLen)
+{
+	uint32_t A;
+	uint32_t L[3];
+	uint8_t m = keyLen / 32; // key words: 3 or 4
+	uint8_t i;
+
+	context->nrSubkeys = (keyLen == 96) ? 26 : 27;
+
+	A = key[m - 1];
+	for (i = 0; i < m - 1; i++)
+	{
+		L[i] = key[m - 2 - i];
+	}
+
+	for (i = 0; i < context->nrSubkeys; i++)
+	{
+		context->subkeys[i] = A;
+		R32(&L[i % (m - 1)], &A, i);
+	}
+}
+
+HOT_CODE void SPECK64_encrypt(Speck64Context* context, const uint32_t* block, uint32_t* out)
+{
+	uint8_t i;
+	uint32_t x = block[0];
+	uint32_t y = block[1];
+
+	for (i = 0; i < context->nrSubkeys; i++)
+	{
+		R32(&x, &y, context->subkeys[i]);
+	}
+
+	out[0] = x;
+	out[1] = y;
+}
+
+HOT_CODE void SPECK64_decrypt(Speck64Context* context, const uint32_t* block, uint32_t* out)
+{
+	int i;
+	uint32_t x = block[0];
+	uint32_t y = block[1];
+
+	for (i = context->nrSubkeys - 1; i >= 0; i--)
+	{
+		RI32(&x, &y, context->subkeys[i]);
+	}
+
+	out[0] = x;
+	out[1] = y;
+}
+
+// Block cipher interface (cipher.h)
+static void speckInit(CipherContext* context, const uint32_t* key, uint16_t keyLen)
+{
+	uint64_t key_in[4];
+	int i;
+
+	for (i = 0; i < keyLen / 64; i++)
+	{
+		key_in[i] = (uint64_t)key[2 * i] << 32 | key[2 * i + 1];
+	}
+
+	SPECK_init(&context->speck, key_in, keyLen);
+}
+
+HOT_CODE static void speckEncrypt(CipherContext* context, const uint32_t* in, uint32_t* out, uint32_t nrBlocks)
+{
+	uint64_t block[2];
+
+	for (; nrBlocks > 0; nrBlocks--)
+	{
+		block[0] = (uint64_t)in[0] << 32 | in[1];
+		block[1] = (uint64_t)in[2] << 32 | in[3];
+
+		SPECK_encrypt(&context->speck, block, block);
+
+		out[0] = (uint32_t)(block[0] >> 32);
+		out[1] = (uint32_t)block[0];
+		out[2] = (uint32_t)(block[1] >> 32);
+		out[3] = (uint32_t)block[1];
+		in += 4;
+		out += 4;
+	}
+}
+
+HOT_CODE static void speckDecrypt(CipherContext* context, const uint32_t* in, uint32_t* out, uint32_t nrBlocks)
+{
+	uint64_t block[2];
+
+	for (; nrBlocks > 0; nrBlocks--)
+	{
+		block[0] = (uint64_t)in[0] << 32 | in[1];
+		block[1] = (uint64_t)in[2] << 32 | in[3];
+
+		SPECK_decrypt(&context->speck, block, block);
+
+		out[0] = (uint32_t)(block[0] >> 32);
+		out[1] = (uint32_t)block[0];
+		out[2] = (uint32_t)(block[1] >> 32);
+		out[3] = (uint32_t)block[1];
+		in += 4;
+		out += 4;
+	}
+}
+
+HOT_CODE static void speckEncryptPair(CipherContext* context, const uint32_t* in, uint32_t* out, uint32_t nrBlocks)
+{
+	SPECK_encrypt_ecb(&context->speck, in, out, nrBlocks);
+}
+
+HOT_CODE static void speckDecryptPair(CipherContext* context, const uint32_t* in, uint32_t* out, uint32_t nrBlocks)
+{
+	SPECK_decrypt_ecb(&context->speck, in, out, nrBlocks);
+}
+
+static void speckEncryptUnrolled(CipherContext* context, const uint32_t* in, uint32_t* out, uint32_t nrBlocks)
+{
+	SPECK_encrypt_unrolled(&context->speck, in, out, nrBlocks);
+}
+
+static void speckDecryptUnrolled(CipherContext* context, const uint32_t* in, uint32_t* out, uint32_t nrBlocks)
+{
+	SPECK_decrypt_unrolled(&context->speck, in, out, nrBlocks);
+}
+
+static void speck64Init(CipherContext* context, const uint32_t* key, uint16_t keyLen)
+{
+	SPECK64_init(&context->speck64, key, keyLen);
+}
+
+HOT_CODE static void speck64Encrypt(CipherContext* context, const uint32_t* in, uint32_t* out, uint32_t nrBlocks)
+{
+	for (; nrBlocks > 0; nrBlocks--)
+	{
+		SPECK64_encrypt(&context->speck64, in, out);
+		in += 2;
+		out += 2;
+	}
+}
+
+HOT_CODE static void speck64Decrypt(CipherContext* context, const uint32_t* in, uint32_t* out, uint32_t nrBlocks)
+{
+	for (; nrBlocks > 0; nrBlocks--)
+	{
+		SPECK64_decrypt(&context->speck64, in, out);
+		in += 2;
+		out += 2;
+	}
+}
+
+const BlockCipher SPECK_128_CIPHER = { "SPECK-128", 4, 128, speckInit, speckEncrypt, speckDecrypt, sizeof(SpeckContext) };
+const BlockCipher SPECK_192_CIPHER = { "SPECK-192", 4, 192, speckInit, speckEncrypt, speckDecrypt, sizeof(SpeckContext) };
+const BlockCipher SPECK_256_CIPHER = { "SPECK-256", 4, 256, speckInit, speckEncrypt, speckDecrypt, sizeof(SpeckContext) };
+const BlockCipher SPECK_128_PAIR_CIPHER = { "SPECK-128-pair", 4, 128, speckInit, speckEncryptPair, speckDecryptPair, sizeof(SpeckContext) };
+const BlockCipher SPECK_192_PAIR_CIPHER = { "SPECK-192-pair", 4, 192, speckInit, speckEncryptPair, speckDecryptPair, sizeof(SpeckContext) };
+const BlockCipher SPECK_256_PAIR_CIPHER = { "SPECK-256-pair", 4, 256, speckInit, speckEncryptPair, speckDecryptPair, sizeof(SpeckContext) };
+const BlockCipher SPECK_128_UNROLLED_CIPHER = { "SPECK-128-unrolled", 4, 128, speckInit, speckEncryptUnrolled, speckDecryptUnrolled, sizeof(SpeckContext) };
+const BlockCipher SPECK_192_UNROLLED_CIPHER = { "SPECK-192-unrolled", 4, 192, speckInit, speckEncryptUnrolled, speckDecryptUnrolled, sizeof(SpeckContext) };
+const BlockCipher SPECK_256_UNROLLED_CIPHER = { "SPECK-256-unrolled", 4, 256, speckInit, speckEncryptUnrolled, speckDecryptUnrolled, sizeof(SpeckContext) };
+const BlockCipher SPECK64_96_CIPHER = { "SPECK64-96", 2, 96, speck64Init, speck64Encrypt, speck64Decrypt, sizeof(Speck64Context) };
+const BlockCipher SPECK64_128_CIPHER = { "SPECK64-128", 2, 128, speck64Init, speck64Encrypt, speck64Decrypt, sizeof(Speck64Context) };
+
 int crypt_main(uint32_t* text, uint32_t* key)
 {
 	SpeckContext context;
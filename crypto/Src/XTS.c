@@ -0,0 +1,99 @@
+/* XTS.c
+*
+ * XTS mode (IEEE 1619) for sector encryption over the block cipher
+ * interface (cipher.h), for the ciphers with a 128 bits block.
+ *
+ * The tweak of the first block is the sector number encrypted with the
+ * tweak key; the following ones are computed incrementally, one
+ * multiplication by alpha per block. The tweaks of XTS_CHUNK_BLOCKS blocks
+ * are computed first, then the whole chunk goes through the cipher in one
+ * call. Sectors are whole blocks, no ciphertext stealing.
+ *
+ */
+
+#include "XTS.h"
+
+static uint32_t swapBytes(uint32_t x)
+{
+	return x >> 24 | (x >> 8 & 0xff00) | (x << 8 & 0xff0000) | x << 24;
+}
+
+// t = t * alpha, t as a little-endian 128 bits number in little-endian words
+static void multiplyAlpha(uint32_t* t)
+{
+	uint32_t carry = t[3] >> 31;
+
+	t[3] = t[3] << 1 | t[2] >> 31;
+	t[2] = t[2] << 1 | t[1] >> 31;
+	t[1] = t[1] << 1 | t[0] >> 31;
+	t[0] = (t[0] << 1) ^ ((0 - carry) & 0x87);
+}
+
+// out = cipher(in ^ T) ^ T over the sector, encrypt or decrypt
+static void cryptSector(XtsContext* context, uint64_t sector, const uint32_t* in, uint32_t* out, uint32_t sectorBytes,
+	void (*crypt)(CipherContext* context, const uint32_t* in, uint32_t* out, uint32_t nrBlocks))
+{
+	uint32_t tweaks[4 * XTS_CHUNK_BLOCKS];
+	uint32_t t[4];
+	uint32_t nrBlocks = sectorBytes / 16;
+	uint32_t n;
+	uint32_t i;
+
+	// T = E2(sector number, little-endian)
+	t[0] = swapBytes((uint32_t)sector);
+	t[1] = swapBytes((uint32_t)(sector >> 32));
+	t[2] = 0;
+	t[3] = 0;
+	context->cipher->encrypt(context->tweakKey, t, t, 1);
+
+	for (i = 0; i < 4; i++)
+	{
+		t[i] = swapBytes(t[i]);
+	}
+
+	for (; nrBlocks > 0; nrBlocks -= n)
+	{
+		n = nrBlocks < XTS_CHUNK_BLOCKS ? nrBlocks : XTS_CHUNK_BLOCKS;
+
+		for (i = 0; i < 4 * n; i += 4)
+		{
+			tweaks[i] = swapBytes(t[0]);
+			tweaks[i + 1] = swapBytes(t[1]);
+			tweaks[i + 2] = swapBytes(t[2]);
+			tweaks[i + 3] = swapBytes(t[3]);
+			multiplyAlpha(t);
+		}
+
+		for (i = 0; i < 4 * n; i++)
+		{
+			out[i] = in[i] ^ tweaks[i];
+		}
+
+		crypt(context->dataKey, out, out, n);
+
+		for (i = 0; i < 4 * n; i++)
+		{
+			out[i] ^= tweaks[i];
+		}
+
+		in += 4 * n;
+		out += 4 * n;
+	}
+}
+
+void XTS_init(XtsContext* context, const BlockCipher* cipher, CipherContext* dataKey, CipherContext* tweakKey)
+{
+	context->cipher = cipher;
+	context->dataKey = dataKey;
+	context->tweakKey = tweakKey;
+}
+
+void XTS_encrypt_sector(XtsContext* context, uint64_t sector, const uint32_t* in, uint32_t* out, uint32_t sectorBytes)
+{
+	cryptSector(context, sector, in, out, sectorBytes, context->cipher->encrypt);
+}
+
+void XTS_decrypt_sector(XtsContext* context, uint64_t sector, const uint32_t* in, uint32_t* out, uint32_t sectorBytes)
+{
+	cryptSector(context, sector, in, out, sectorBytes, context->cipher->decrypt);
+}
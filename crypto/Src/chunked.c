@@ -0,0 +1,51 @@
+/* chunked.c
+*
+ * Resumable ECB and CTR over long buffers: the context keeps the next
+ * input and output block and the blocks left, and every step hands at most
+ * maxBlocks blocks to the cipher or CTR_crypt in one call, so the
+ * multi-block kernels still get whole groups.
+ *
+ */
+
+#include "chunked.h"
+
+void CHUNKED_init(ChunkedContext* context, const BlockCipher* cipher, CipherContext* key, CtrContext* ctr,
+	uint8_t direction, const uint32_t* in, uint32_t* out, uint32_t nrBlocks)
+{
+	context->cipher = cipher;
+	context->key = key;
+	context->ctr = ctr;
+	context->direction = direction;
+	context->in = in;
+	context->out = out;
+	context->blocksLeft = nrBlocks;
+}
+
+uint32_t CHUNKED_step(ChunkedContext* context, uint32_t maxBlocks)
+{
+	uint32_t n = context->blocksLeft < maxBlocks ? context->blocksLeft : maxBlocks;
+	uint32_t nrWords = n * context->cipher->blockWords;
+
+	if (n == 0)
+	{
+		return context->blocksLeft;
+	}
+
+	if (context->ctr)
+	{
+		CTR_crypt(context->ctr, context->in, context->out, nrWords);
+	}
+	else if (context->direction == CHUNKED_ENCRYPT)
+	{
+		context->cipher->encrypt(context->key, context->in, context->out, n);
+	}
+	else
+	{
+		context->cipher->decrypt(context->key, context->in, context->out, n);
+	}
+
+	context->in += nrWords;
+	context->out += nrWords;
+	context->blocksLeft -= n;
+	return context->blocksLeft;
+}
@@ -0,0 +1,139 @@
+/* cipher.c
+*
+ * Registry of the block ciphers compiled in (see config.h), and the byte
+ * buffer interface on top of it.
+ *
+ */
+
+#include <string.h>
+#include "cipher.h"
+#include "simd.h"
+
+const BlockCipher* const CIPHERS[] =
+{
+#ifdef USE_AES
+	&AES_128_CIPHER,
+	&AES_192_CIPHER,
+	&AES_256_CIPHER,
+#endif
+#ifdef USE_ARIA
+	&ARIA_128_CIPHER,
+	&ARIA_192_CIPHER,
+	&ARIA_256_CIPHER,
+#endif
+#ifdef USE_CAMELLIA
+	&CAMELLIA_128_CIPHER,
+	&CAMELLIA_192_CIPHER,
+	&CAMELLIA_256_CIPHER,
+#endif
+#ifdef USE_GOST
+	&GOST_CIPHER,
+#endif
+#ifdef USE_HIGHT
+	&HIGHT_CIPHER,
+	&HIGHT_X4_CIPHER,
+#endif
+#ifdef USE_IDEA
+	&IDEA_CIPHER,
+	&IDEA_X2_CIPHER,
+#endif
+#ifdef USE_NOEKEON
+	&NOEKEON_CIPHER,
+	&NOEKEON_DIRECT_CIPHER,
+	&NOEKEON_INDIRECT_CIPHER,
+#endif
+#ifdef USE_PRESENT
+	&PRESENT_80_CIPHER,
+	&PRESENT_128_CIPHER,
+#endif
+#ifdef USE_SEED
+	&SEED_CIPHER,
+#endif
+#ifdef USE_SIMON
+	&SIMON_128_CIPHER,
+	&SIMON_192_CIPHER,
+	&SIMON_256_CIPHER,
+	&SIMON_128_PAIR_CIPHER,
+	&SIMON_192_PAIR_CIPHER,
+	&SIMON_256_PAIR_CIPHER,
+	&SIMON_128_UNROLLED_CIPHER,
+	&SIMON_192_UNROLLED_CIPHER,
+	&SIMON_256_UNROLLED_CIPHER,
+	&SIMON64_96_CIPHER,
+	&SIMON64_128_CIPHER,
+#endif
+#ifdef USE_SPECK
+	&SPECK_128_CIPHER,
+	&SPECK_192_CIPHER,
+	&SPECK_256_CIPHER,
+	&SPECK_128_PAIR_CIPHER,
+	&SPECK_192_PAIR_CIPHER,
+	&SPECK_256_PAIR_CIPHER,
+	&SPECK_128_UNROLLED_CIPHER,
+	&SPECK_192_UNROLLED_CIPHER,
+	&SPECK_256_UNROLLED_CIPHER,
+	&SPECK64_96_CIPHER,
+	&SPECK64_128_CIPHER,
+#endif
+};
+
+const uint32_t NR_CIPHERS = sizeof(CIPHERS) / sizeof(CIPHERS[0]);
+
+/*
+* The word packing is big-endian and the Cortex-M4 little-endian: a word
+* is read with a (possibly unaligned) 32-bit load and its bytes reversed
+* with a single REV, instead of four loads, shifts and ORs.
+*/
+
+void CIPHER_load_words(const uint8_t* bytes, uint32_t* words, uint32_t nrWords)
+{
+	uint32_t w;
+
+	for (; nrWords > 0; nrWords--)
+	{
+		memcpy(&w, bytes, 4);
+		*words++ = REV(w);
+		bytes += 4;
+	}
+}
+
+void CIPHER_store_words(const uint32_t* words, uint8_t* bytes, uint32_t nrWords)
+{
+	uint32_t w;
+
+	for (; nrWords > 0; nrWords--)
+	{
+		w = REV(*words++);
+		memcpy(bytes, &w, 4);
+		bytes += 4;
+	}
+}
+
+static void cryptBytes(const BlockCipher* cipher, CipherContext* context, const uint8_t* in, uint8_t* out, uint32_t nrBlocks,
+	void (*crypt)(CipherContext* context, const uint32_t* in, uint32_t* out, uint32_t nrBlocks))
+{
+	uint32_t words[CIPHER_CHUNK_BLOCKS * MAX_BLOCK_WORDS];
+	uint32_t n;
+
+	for (; nrBlocks > 0; nrBlocks -= n)
+	{
+		n = nrBlocks < CIPHER_CHUNK_BLOCKS ? nrBlocks : CIPHER_CHUNK_BLOCKS;
+
+		CIPHER_load_words(in, words, n * cipher->blockWords);
+		crypt(context, words, words, n);
+		CIPHER_store_words(words, out, n * cipher->blockWords);
+
+		in += 4 * n * cipher->blockWords;
+		out += 4 * n * cipher->blockWords;
+	}
+}
+
+void CIPHER_encrypt_bytes(const BlockCipher* cipher, CipherContext* context, const uint8_t* in, uint8_t* out, uint32_t nrBlocks)
+{
+	cryptBytes(cipher, context, in, out, nrBlocks, cipher->encrypt);
+}
+
+void CIPHER_decrypt_bytes(const BlockCipher* cipher, CipherContext* context, const uint8_t* in, uint8_t* out, uint32_t nrBlocks)
+{
+	cryptBytes(cipher, context, in, out, nrBlocks, cipher->decrypt);
+}
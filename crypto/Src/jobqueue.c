@@ -0,0 +1,82 @@
+/* jobqueue.c
+*
+ * Lock-free single-producer/single-consumer queue of block cipher jobs.
+ *
+ * head and tail are free running counters, each written by one side only:
+ * the slot of a job is written before head is advanced past it, and a job
+ * leaves the queue (tail advanced) only once its callback has returned, so
+ * a full queue never overwrites a job still running. The barriers keep
+ * the compiler and the core from reordering the slot accesses around the
+ * index updates.
+ *
+ */
+
+#include "jobqueue.h"
+
+void JOBQ_init(JobQueue* queue, uint32_t (*now)(void), void (*kick)(void))
+{
+	queue->head = 0;
+	queue->tail = 0;
+	queue->now = now;
+	queue->kick = kick;
+}
+
+uint32_t JOBQ_pending(const JobQueue* queue)
+{
+	return queue->head - queue->tail;
+}
+
+int JOBQ_submit(JobQueue* queue, CryptoJob* job)
+{
+	uint32_t head = queue->head;
+
+	if (head - queue->tail >= JOBQ_SIZE)
+	{
+		return -1;
+	}
+
+	job->submitted = queue->now ? queue->now() : 0;
+	queue->jobs[head & (JOBQ_SIZE - 1)] = job;
+	__sync_synchronize();
+	queue->head = head + 1;
+
+	if (queue->kick)
+	{
+		queue->kick();
+	}
+	return 0;
+}
+
+uint32_t JOBQ_process(JobQueue* queue)
+{
+	uint32_t tail = queue->tail;
+	uint32_t done = 0;
+	CryptoJob* job;
+
+	while (tail != queue->head)
+	{
+		__sync_synchronize();
+		job = queue->jobs[tail & (JOBQ_SIZE - 1)];
+
+		job->started = queue->now ? queue->now() : 0;
+		if (job->direction == JOB_ENCRYPT)
+		{
+			job->cipher->encrypt(job->key, job->in, job->out, job->nrBlocks);
+		}
+		else
+		{
+			job->cipher->decrypt(job->key, job->in, job->out, job->nrBlocks);
+		}
+		job->finished = queue->now ? queue->now() : 0;
+
+		if (job->callback)
+		{
+			job->callback(job);
+		}
+
+		__sync_synchronize();
+		queue->tail = ++tail;
+		done++;
+	}
+	return done;
+}
@@ -0,0 +1,124 @@
+/* stream.c
+*
+ * Streaming ECB encryption and decryption of byte strings of any length
+ * over the block cipher interface (cipher.h), PKCS#7 padded.
+ *
+ * Only the bytes of a partial block are kept in the context. The whole
+ * blocks of every update go from the caller's buffer to the byte API of
+ * cipher.h, which hands CIPHER_CHUNK_BLOCKS at a time to the cipher so the
+ * multi-block kernels get full groups. When decrypting, the last whole
+ * block is held back until STREAM_final since it carries the padding.
+ *
+ */
+
+#include <string.h>
+#include "stream.h"
+
+// nrBlocks whole blocks from in to out
+static void cryptBlocks(StreamContext* context, const uint8_t* in, uint8_t* out, uint32_t nrBlocks)
+{
+	if (context->direction == STREAM_ENCRYPT)
+	{
+		CIPHER_encrypt_bytes(context->cipher, context->key, in, out, nrBlocks);
+	}
+	else
+	{
+		CIPHER_decrypt_bytes(context->cipher, context->key, in, out, nrBlocks);
+	}
+}
+
+void STREAM_init(StreamContext* context, const BlockCipher* cipher, CipherContext* key, uint8_t direction)
+{
+	context->cipher = cipher;
+	context->key = key;
+	context->direction = direction;
+	context->bufferLen = 0;
+}
+
+uint32_t STREAM_update(StreamContext* context, const uint8_t* in, uint32_t len, uint8_t* out)
+{
+	uint8_t blockBytes = 4 * context->cipher->blockWords;
+	uint32_t written = 0;
+	uint32_t nrBlocks;
+	uint32_t n;
+
+	if (context->bufferLen > 0)
+	{
+		n = blockBytes - context->bufferLen;
+		if (n > len)
+		{
+			n = len;
+		}
+
+		memcpy(context->buffer + context->bufferLen, in, n);
+		context->bufferLen += n;
+		in += n;
+		len -= n;
+
+		// a full buffer is processed unless it may be the last block of a decryption
+		if (context->bufferLen < blockBytes || (context->direction == STREAM_DECRYPT && len == 0))
+		{
+			return 0;
+		}
+
+		cryptBlocks(context, context->buffer, out, 1);
+		context->bufferLen = 0;
+		out += blockBytes;
+		written = blockBytes;
+	}
+
+	nrBlocks = len / blockBytes;
+	if (context->direction == STREAM_DECRYPT && nrBlocks > 0 && len % blockBytes == 0)
+	{
+		nrBlocks--;
+	}
+
+	cryptBlocks(context, in, out, nrBlocks);
+	in += nrBlocks * blockBytes;
+	len -= nrBlocks * blockBytes;
+	written += nrBlocks * blockBytes;
+
+	memcpy(context->buffer, in, len);
+	context->bufferLen = len;
+
+	return written;
+}
+
+int32_t STREAM_final(StreamContext* context, uint8_t* out)
+{
+	uint8_t blockBytes = 4 * context->cipher->blockWords;
+	uint8_t pad;
+	uint8_t bad;
+	uint8_t i;
+
+	if (context->direction == STREAM_ENCRYPT)
+	{
+		pad = blockBytes - context->bufferLen;
+		memset(context->buffer + context->bufferLen, pad, pad);
+		cryptBlocks(context, context->buffer, out, 1);
+		context->bufferLen = 0;
+		return blockBytes;
+	}
+
+	if (context->bufferLen != blockBytes)
+	{
+		return -1;
+	}
+
+	cryptBlocks(context, context->buffer, context->buffer, 1);
+	context->bufferLen = 0;
+
+	pad = context->buffer[blockBytes - 1];
+	bad = (pad == 0 || pad > blockBytes);
+	for (i = blockBytes - pad; !bad && i < blockBytes; i++)
+	{
+		bad = (context->buffer[i] != pad);
+	}
+	if (bad)
+	{
+		return -1;
+	}
+
+	memcpy(out, context->buffer, blockBytes - pad);
+	return blockBytes - pad;
+}